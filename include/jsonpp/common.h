@@ -26,10 +26,14 @@
 #include "metapp/utilities/utility.h"
 #include "metapp/compiler.h"
 
+#include "jsonpp/hashobject.h"
+#include "jsonpp/stringview.h"
+
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
 #include <cstdint>
 
 namespace jsonpp {
@@ -42,6 +46,14 @@ using JsonReal = double;
 using JsonString = std::string;
 using JsonArray = std::vector<metapp::Variant>;
 using JsonObject = std::map<std::string, metapp::Variant>;
+// The members are sorted by key, use std::lower_bound to find a member.
+// It's a distinct type rather than an alias, so a plain std::vector<std::pair<std::string, metapp::Variant> >
+// is still parsed and dumped as an array.
+class JsonFlatObject : public std::vector<std::pair<std::string, metapp::Variant> >
+{
+public:
+	using std::vector<std::pair<std::string, metapp::Variant> >::vector;
+};
 
 enum class JsonType {
 	jtNone,
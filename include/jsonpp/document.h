@@ -0,0 +1,228 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_DOCUMENT_H_821598293712
+#define JSONPP_DOCUMENT_H_821598293712
+
+#include "jsonpp/common.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// A monotonic allocator. Memory is allocated from large blocks and is never freed individually.
+// Releasing all memory costs one deallocation per block, not per allocation.
+class MonotonicArena
+{
+public:
+	explicit MonotonicArena(const std::size_t initialBlockSize = 4096);
+	~MonotonicArena();
+
+	MonotonicArena(MonotonicArena && other);
+	MonotonicArena & operator = (MonotonicArena && other);
+
+	void * allocate(const std::size_t size, const std::size_t alignment);
+
+	// Release all allocations. The largest block is kept to be reused by the next allocations.
+	void reset();
+
+	// The total bytes of the blocks owned by the arena.
+	std::size_t getCapacity() const;
+
+private:
+	MonotonicArena(const MonotonicArena &) = delete;
+	MonotonicArena & operator = (const MonotonicArena &) = delete;
+
+	void addBlock(const std::size_t minSize);
+
+private:
+	std::vector<std::unique_ptr<char[]> > blockList;
+	std::vector<std::size_t> blockSizeList;
+	char * current;
+	char * end;
+	std::size_t initialBlockSize;
+};
+
+template <typename Implement>
+class DocumentBuilder;
+
+class IncrementalTokenizer;
+
+} // namespace internal_
+
+struct JsonMember;
+class StringPool;
+
+// A node in JsonDocument. All memory of the node is owned by the document, and the node is trivially destructible.
+class JsonNode
+{
+public:
+	JsonNode();
+
+	JsonType getType() const {
+		return type;
+	}
+
+	bool isNull() const {
+		return type == JsonType::jtNull;
+	}
+
+	JsonBool getBool() const {
+		return value.b;
+	}
+
+	JsonInt getInt() const {
+		return value.i;
+	}
+
+	JsonUnsignedInt getUnsignedInt() const {
+		return value.u;
+	}
+
+	JsonReal getReal() const {
+		return value.d;
+	}
+
+	// The string is null terminated, it may contain '\0' as well, use getStringLength for the length.
+	const char * getString() const {
+		return value.s;
+	}
+
+	std::size_t getStringLength() const {
+		return length;
+	}
+
+	JsonStringView getStringView() const {
+		return JsonStringView(value.s, length);
+	}
+
+	// The element count of array, or member count of object, or 0 for other types.
+	std::size_t getSize() const;
+
+	// Returns the array element at `index`.
+	const JsonNode & operator[] (const std::size_t index) const {
+		return value.elements[index];
+	}
+
+	// Returns the object member at `index`, in the order in the JSON document.
+	const JsonMember & getMember(const std::size_t index) const;
+
+	// Find the object member value by key, returns nullptr if not found or the node is not object.
+	const JsonNode * find(const char * key, const std::size_t keyLength) const;
+	const JsonNode * find(const std::string & key) const {
+		return find(key.c_str(), key.size());
+	}
+
+	// Convert the node to the default data types, such as JsonArray and JsonObject.
+	metapp::Variant toVariant() const;
+
+private:
+	JsonType type;
+	uint32_t length;
+	union {
+		JsonBool b;
+		JsonInt i;
+		JsonUnsignedInt u;
+		JsonReal d;
+		const char * s;
+		const JsonNode * elements;
+		const JsonMember * members;
+	} value;
+
+	template <typename Implement>
+	friend class internal_::DocumentBuilder;
+	friend class internal_::IncrementalTokenizer;
+};
+
+struct JsonMember
+{
+	const char * key;
+	std::size_t keyLength;
+	JsonNode value;
+};
+
+inline const JsonMember & JsonNode::getMember(const std::size_t index) const
+{
+	return value.members[index];
+}
+
+// JsonDocument holds a parsed JSON tree which nodes, keys, and strings are allocated from a monotonic arena
+// owned by the document. Destroying or clearing the document costs one deallocation per arena block.
+class JsonDocument
+{
+public:
+	JsonDocument();
+	~JsonDocument();
+
+	JsonDocument(JsonDocument && other);
+	JsonDocument & operator = (JsonDocument && other);
+
+	const JsonNode & getRoot() const {
+		return root;
+	}
+
+	// Release all nodes. The arena memory is kept for the next parse, the parser memory in zero copy mode is released.
+	void clear();
+
+	// Bytes reserved by the arena.
+	std::size_t getMemorySize() const;
+
+	// If the string pool is set, the keys and strings that can be pooled are shared in the pool instead of
+	// being copied to the document arena. The pool can be shared by several documents, the document keeps the pool alive.
+	// If the pool is not set, the pool in ParserConfig is used when parsing, if any.
+	const std::shared_ptr<StringPool> & getStringPool() const {
+		return stringPool;
+	}
+
+	JsonDocument & setStringPool(const std::shared_ptr<StringPool> & stringPool_) {
+		stringPool = stringPool_;
+		return *this;
+	}
+
+private:
+	JsonDocument(const JsonDocument &) = delete;
+	JsonDocument & operator = (const JsonDocument &) = delete;
+
+	internal_::MonotonicArena & getArena() {
+		return arena;
+	}
+
+	JsonNode & getMutableRoot() {
+		return root;
+	}
+
+private:
+	internal_::MonotonicArena arena;
+	JsonNode root;
+	std::shared_ptr<StringPool> stringPool;
+	// The parser memory that the nodes refer to, in zero copy mode.
+	std::shared_ptr<void> backendBuffer;
+
+	template <typename Implement>
+	friend class internal_::DocumentBuilder;
+	friend class internal_::IncrementalTokenizer;
+};
+
+
+} // namespace jsonpp
+
+#endif
@@ -0,0 +1,112 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef JSONPP_ENUMCACHE_H_821598293712
+#define JSONPP_ENUMCACHE_H_821598293712
+
+#include "metapp/interfaces/metaenum.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// EnumCache is built once for each MetaEnum, and shared by all parsers and dumpers.
+// It finds the value by name with a hash table, without creating any temporary string, and finds the name by value
+// with a dense table if the values are in a small range, or a hash table otherwise.
+class EnumCache
+{
+public:
+	struct Item
+	{
+		std::string name;
+		// The name quoted and escaped as JSON string, it's written by TextOutput as is.
+		std::string encodedName;
+		long long value;
+	};
+
+public:
+	explicit EnumCache(const metapp::MetaEnum * metaEnum);
+
+	// Returns nullptr if no item has `name`.
+	const Item * findByName(const char * name, const std::size_t nameLength) const;
+
+	// Returns nullptr if no item has `value`. If several items have the same value, the first one is returned.
+	const Item * findByValue(const long long value) const {
+		if(! denseIndexList.empty()) {
+			const unsigned long long offset = static_cast<unsigned long long>(value) - static_cast<unsigned long long>(minValue);
+			if(offset >= denseIndexList.size() || denseIndexList[offset] == 0) {
+				return nullptr;
+			}
+			return &itemList[denseIndexList[offset] - 1];
+		}
+		const auto it = valueIndexMap.find(value);
+		if(it == valueIndexMap.end()) {
+			return nullptr;
+		}
+		return &itemList[it->second];
+	}
+
+private:
+	std::vector<Item> itemList;
+	// Open addressing table, each slot is the item index + 1, 0 means empty slot.
+	std::vector<uint32_t> nameSlotList;
+	std::size_t nameSlotMask;
+	// If it's not empty, denseIndexList[value - minValue] is the item index + 1, 0 means no item.
+	std::vector<uint32_t> denseIndexList;
+	long long minValue;
+	std::unordered_map<long long, std::size_t> valueIndexMap;
+};
+
+// Returns the cached EnumCache for metaEnum, the cache is created on first call. It's thread safe,
+// and it only locks the first time each thread looks up the enum.
+const EnumCache * getEnumCache(const metapp::MetaEnum * metaEnum);
+
+// Remembers the EnumCache used by a parser or dumper, so the hash lookup in getEnumCache is skipped.
+// A document usually has only a few enum types, so the list is searched linearly.
+class EnumCacheList
+{
+public:
+	EnumCacheList() : cacheList() {
+	}
+
+	const EnumCache * get(const metapp::MetaEnum * metaEnum) {
+		for(const auto & item : cacheList) {
+			if(item.first == metaEnum) {
+				return item.second;
+			}
+		}
+		const EnumCache * cache = getEnumCache(metaEnum);
+		cacheList.push_back(std::make_pair(metaEnum, cache));
+		return cache;
+	}
+
+private:
+	std::vector<std::pair<const metapp::MetaEnum *, const EnumCache *> > cacheList;
+};
+
+} // namespace internal_
+
+} // namespace jsonpp
+
+#endif
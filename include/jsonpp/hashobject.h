@@ -0,0 +1,221 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_HASHOBJECT_H_821598293712
+#define JSONPP_HASHOBJECT_H_821598293712
+
+#include "metapp/variant.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+inline uint64_t hashKey(const char * key, const std::size_t keyLength)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for(std::size_t i = 0; i < keyLength; ++i) {
+		hash ^= static_cast<unsigned char>(key[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+} // namespace internal_
+
+// An object type which keeps the members in insertion order, and finds the members with an open addressing hash table.
+// The members are stored contiguously, iterating them doesn't chase pointers as std::map does.
+// Same as std::map::insert, inserting an existing key doesn't change the existing value.
+class JsonHashObject
+{
+public:
+	using key_type = std::string;
+	using mapped_type = metapp::Variant;
+	using value_type = std::pair<std::string, metapp::Variant>;
+	using size_type = std::size_t;
+	using iterator = std::vector<value_type>::iterator;
+	using const_iterator = std::vector<value_type>::const_iterator;
+
+public:
+	JsonHashObject()
+		: memberList(), slotList(), slotMask(0)
+	{
+	}
+
+	size_type size() const {
+		return memberList.size();
+	}
+
+	bool empty() const {
+		return memberList.empty();
+	}
+
+	void reserve(const size_type count) {
+		memberList.reserve(count);
+		if(getSlotCount(count) > slotList.size()) {
+			rehash(getSlotCount(count));
+		}
+	}
+
+	void clear() {
+		memberList.clear();
+		slotList.clear();
+		slotMask = 0;
+	}
+
+	iterator begin() {
+		return memberList.begin();
+	}
+
+	iterator end() {
+		return memberList.end();
+	}
+
+	const_iterator begin() const {
+		return memberList.begin();
+	}
+
+	const_iterator end() const {
+		return memberList.end();
+	}
+
+	iterator find(const char * key, const size_type keyLength) {
+		const size_type index = findIndex(key, keyLength);
+		return index == npos ? end() : begin() + index;
+	}
+
+	const_iterator find(const char * key, const size_type keyLength) const {
+		const size_type index = findIndex(key, keyLength);
+		return index == npos ? end() : begin() + index;
+	}
+
+	iterator find(const std::string & key) {
+		return find(key.data(), key.size());
+	}
+
+	const_iterator find(const std::string & key) const {
+		return find(key.data(), key.size());
+	}
+
+	size_type count(const std::string & key) const {
+		return findIndex(key.data(), key.size()) == npos ? 0 : 1;
+	}
+
+	std::pair<iterator, bool> insert(value_type value) {
+		const uint64_t hash = internal_::hashKey(value.first.data(), value.first.size());
+		const size_type index = findIndex(value.first.data(), value.first.size(), hash);
+		if(index != npos) {
+			return std::make_pair(begin() + index, false);
+		}
+		return std::make_pair(doInsert(std::move(value), hash), true);
+	}
+
+	mapped_type & operator[] (const std::string & key) {
+		return insert(value_type(key, metapp::Variant())).first->second;
+	}
+
+	// Erasing needs to rebuild the hash table, it's O(n).
+	size_type erase(const std::string & key) {
+		const size_type index = findIndex(key.data(), key.size());
+		if(index == npos) {
+			return 0;
+		}
+		memberList.erase(memberList.begin() + index);
+		rehash(slotList.size());
+		return 1;
+	}
+
+private:
+	static constexpr size_type npos = static_cast<size_type>(-1);
+
+	// Keep the load factor below 0.5.
+	static size_type getSlotCount(const size_type count) {
+		size_type slotCount = 8;
+		while(slotCount < count * 2) {
+			slotCount <<= 1;
+		}
+		return slotCount;
+	}
+
+	size_type findIndex(const char * key, const size_type keyLength) const {
+		if(memberList.empty()) {
+			return npos;
+		}
+		return findIndex(key, keyLength, internal_::hashKey(key, keyLength));
+	}
+
+	size_type findIndex(const char * key, const size_type keyLength, const uint64_t hash) const {
+		if(slotList.empty()) {
+			return npos;
+		}
+		size_type slot = static_cast<size_type>(hash) & slotMask;
+		for(;;) {
+			const uint32_t memberIndex = slotList[slot];
+			if(memberIndex == 0) {
+				return npos;
+			}
+			const std::string & name = memberList[memberIndex - 1].first;
+			if(name.size() == keyLength && memcmp(name.data(), key, keyLength) == 0) {
+				return memberIndex - 1;
+			}
+			slot = (slot + 1) & slotMask;
+		}
+	}
+
+	iterator doInsert(value_type && value, const uint64_t hash) {
+		if(getSlotCount(memberList.size() + 1) > slotList.size()) {
+			rehash(getSlotCount(memberList.size() + 1));
+		}
+		memberList.push_back(std::move(value));
+		placeSlot(hash, static_cast<uint32_t>(memberList.size()));
+		return memberList.end() - 1;
+	}
+
+	void placeSlot(const uint64_t hash, const uint32_t memberIndex) {
+		size_type slot = static_cast<size_type>(hash) & slotMask;
+		while(slotList[slot] != 0) {
+			slot = (slot + 1) & slotMask;
+		}
+		slotList[slot] = memberIndex;
+	}
+
+	void rehash(const size_type slotCount) {
+		slotList.assign(slotCount, 0);
+		slotMask = slotCount - 1;
+		for(size_type i = 0; i < memberList.size(); ++i) {
+			const std::string & name = memberList[i].first;
+			placeSlot(internal_::hashKey(name.data(), name.size()), static_cast<uint32_t>(i + 1));
+		}
+	}
+
+private:
+	std::vector<value_type> memberList;
+	// Open addressing table, each slot is the member index + 1, 0 means empty slot.
+	std::vector<uint32_t> slotList;
+	size_type slotMask;
+};
+
+
+} // namespace jsonpp
+
+#endif
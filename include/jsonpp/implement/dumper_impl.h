@@ -17,23 +17,42 @@
 #ifndef JSONPP_DUMPER_IMPL_H_821598293712
 #define JSONPP_DUMPER_IMPL_H_821598293712
 
+#include "jsonpp/enumcache.h"
+
 #include "metapp/variant.h"
 
 #include <memory>
 #include <ostream>
 #include <cstdio>
 #include <cstring>
+#include <type_traits>
+#include <utility>
 
 namespace jsonpp {
 
 namespace internal_ {
 
+// Detects whether Output has `writeEncodedString(const char * s, std::size_t length)` which writes the quoted
+// and escaped string as is, such as TextOutput.
+template <typename Output>
+struct HasWriteEncodedString
+{
+private:
+	template <typename C>
+	static std::true_type test(decltype(std::declval<const C &>().writeEncodedString((const char *)nullptr, std::size_t())) *);
+	template <typename C>
+	static std::false_type test(...);
+
+public:
+	static constexpr bool value = decltype(test<Output>(nullptr))::value;
+};
+
 template <typename Output>
 class DumperImplement
 {
 public:
 	DumperImplement(const DumperConfig & config, const Output & output)
-		: config(config), output(output), indentList(), buffer()
+		: config(config), output(output), indentList(), buffer(), enumCacheList()
 	{
 	}
 
@@ -70,6 +89,11 @@ private:
 			doDumpString(value.get<const std::string &>());
 			return;
 		}
+		if(metaType == metapp::getMetaType<JsonStringView>()) {
+			const JsonStringView & s = value.get<const JsonStringView &>();
+			output.writeString(s.data(), s.size());
+			return;
+		}
 		if(metaType->isArray() && metaType->getUpType()->getTypeKind() == metapp::tkChar) {
 			output.writeString(value.get<char []>());
 			return;
@@ -105,10 +129,9 @@ private:
 		if(metaType->isEnum()) {
 			const auto enumValue = value.cast<JsonInt>().template get<JsonInt>();
 			if(config.allowNamedEnum() && metaType->hasMetaEnum()) {
-				const metapp::MetaEnum * metaEnum = metaType->getMetaEnum();
-				const metapp::MetaItem & metaItem = metaEnum->getByValue(enumValue);
-				if(! metaItem.isEmpty()) {
-					doDumpString(metaItem.getName());
+				const EnumCache::Item * item = enumCacheList.get(metaType->getMetaEnum())->findByValue(enumValue);
+				if(item != nullptr) {
+					doDumpEnumName(*item, std::integral_constant<bool, HasWriteEncodedString<Output>::value>());
 					return;
 				}
 			}
@@ -121,12 +144,35 @@ private:
 		output.writeString(s.c_str(), s.size());
 	}
 
+	// The name is already quoted and escaped, it's written without being escaped again.
+	void doDumpEnumName(const EnumCache::Item & item, std::true_type) {
+		output.writeEncodedString(item.encodedName.c_str(), item.encodedName.size());
+	}
+
+	void doDumpEnumName(const EnumCache::Item & item, std::false_type) {
+		doDumpString(item.name);
+	}
+
 	bool doDumpObject(const metapp::Variant & value) {
 		auto metaType = metapp::getNonReferenceMetaType(value.getMetaType());
 		if(config.isArrayType(metaType)) {
 			return false;
 		}
 
+		// The native object types are dumped directly without the meta interfaces.
+		if(metaType == metapp::getMetaType<JsonObject>()) {
+			doDumpMembers(value.get<const JsonObject &>());
+			return true;
+		}
+		if(metaType == metapp::getMetaType<JsonHashObject>()) {
+			doDumpMembers(value.get<const JsonHashObject &>());
+			return true;
+		}
+		if(metaType == metapp::getMetaType<JsonFlatObject>()) {
+			doDumpMembers(value.get<const JsonFlatObject &>());
+			return true;
+		}
+
 		constexpr int asNone = 0;
 		constexpr int asMap = 1;
 		constexpr int asIndexable = 2;
@@ -198,6 +244,18 @@ private:
 		return true;
 	}
 
+	template <typename Container>
+	void doDumpMembers(const Container & container) {
+		output.beginObject();
+		std::size_t index = 0;
+		for(const auto & member : container) {
+			output.beginObjectItem(member.first, index++);
+			doDumpValue(member.second);
+			output.endObjectItem();
+		}
+		output.endObject();
+	}
+
 	bool doDumpArray(const metapp::Variant & value) {
 		auto metaType = metapp::getNonReferenceMetaType(value.getMetaType());
 		const metapp::MetaIterable * metaIterable = metaType->getMetaIterable();
@@ -236,6 +294,7 @@ private:
 	const Output & output;
 	std::vector<std::string> indentList;
 	std::array<char, 128> buffer;
+	EnumCacheList enumCacheList;
 };
 
 
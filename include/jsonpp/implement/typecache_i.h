@@ -0,0 +1,73 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_TYPECACHE_I_H_821598293712
+#define JSONPP_TYPECACHE_I_H_821598293712
+
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// TypeCache holds the items created for the meta types, such as the parse plan of a MetaClass.
+// The items are created on first use and are never destroyed, so the returned pointers are always valid.
+// Each thread also keeps a map of the items it has looked up, which is passed to `get`, so the mutex is only
+// locked the first time a thread meets a key. After that the lookups don't lock, and the threads parsing
+// the same types don't contend.
+template <typename Key, typename Item>
+class TypeCache
+{
+public:
+	using ThreadMap = std::unordered_map<Key, const Item *>;
+
+	TypeCache() : mutex(), itemMap() {
+	}
+
+	// `creator` has the prototype `std::unique_ptr<Item> creator(Key key)`, it may return nullptr, which is cached too.
+	template <typename Creator>
+	const Item * get(ThreadMap & threadMap, const Key key, const Creator & creator) {
+		const auto threadIt = threadMap.find(key);
+		if(threadIt != threadMap.end()) {
+			return threadIt->second;
+		}
+
+		const Item * item;
+		{
+			std::lock_guard<std::mutex> lockGuard(mutex);
+			auto it = itemMap.find(key);
+			if(it == itemMap.end()) {
+				it = itemMap.insert(std::make_pair(key, creator(key))).first;
+			}
+			item = it->second.get();
+		}
+		threadMap.insert(std::make_pair(key, item));
+		return item;
+	}
+
+private:
+	std::mutex mutex;
+	std::unordered_map<Key, std::unique_ptr<Item> > itemMap;
+};
+
+} // namespace internal_
+
+} // namespace jsonpp
+
+#endif
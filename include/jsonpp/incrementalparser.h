@@ -0,0 +1,87 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_INCREMENTALPARSER_H_821598293712
+#define JSONPP_INCREMENTALPARSER_H_821598293712
+
+#include "jsonpp/parser.h"
+
+#include <memory>
+#include <string>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+class IncrementalTokenizer;
+
+} // namespace internal_
+
+// IncrementalParser parses a JSON document which arrives in chunks, such as from a socket.
+// Each chunk is tokenized as soon as it's fed, the tokenizer state is kept between chunks, so a token
+// (a string, a number, etc) can be split at any byte. The whole document is never buffered.
+// For valid JSON, the result is the same as Parser::parse with the same config and prototype.
+// The strings are not validated as UTF-8, so some invalid input that backend simdjson rejects is accepted,
+// see the backend comparison in doc/parser.md.
+class IncrementalParser
+{
+public:
+	IncrementalParser();
+	explicit IncrementalParser(const ParserConfig & config);
+	~IncrementalParser();
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	// Feed the next chunk of the document. Returns false if there is any error, the following chunks are ignored.
+	// The first feed after finish() starts a new document.
+	bool feed(const char * data, const std::size_t length);
+	bool feed(const std::string & data);
+
+	// Returns true if a complete JSON value has been fed. Note a number at the root level is complete only after finish().
+	bool isComplete() const;
+
+	// End the document and return the parsed value, or empty Variant if there is any error.
+	// JsonStringView in the result refers to the parser memory, it's valid until the next feed or reset.
+	metapp::Variant finish(const metapp::MetaType * prototype = nullptr);
+
+	template <typename T>
+	T finish() {
+		const metapp::Variant result = finish(metapp::getMetaType<T>());
+		if(hasError()) {
+			return T();
+		}
+		return result.get<const T &>();
+	}
+
+	// Discard the fed data and start a new document.
+	void reset();
+
+private:
+	IncrementalParser(const IncrementalParser &) = delete;
+	IncrementalParser & operator = (const IncrementalParser &) = delete;
+
+private:
+	ParserConfig config;
+	std::unique_ptr<internal_::IncrementalTokenizer> tokenizer;
+	std::string errorMessage;
+	bool finished;
+};
+
+
+} // namespace jsonpp
+
+#endif
@@ -0,0 +1,69 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_KEYFILTER_H_821598293712
+#define JSONPP_KEYFILTER_H_821598293712
+
+#include "jsonpp/stringview.h"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// The include and exclude key sets in ParserConfig, for each object depth, or for any depth.
+// The depth is the count of arrays and objects that contain the object, the root object has depth 0.
+class KeyFilter
+{
+private:
+	// The keys are sorted and unique, so a JsonStringView key can be found with binary search
+	// without creating a std::string.
+	struct Rule
+	{
+		Rule() : includeList(), excludeList() {
+		}
+
+		std::vector<std::string> includeList;
+		std::vector<std::string> excludeList;
+	};
+
+public:
+	static constexpr int anyDepth = -1;
+
+	KeyFilter();
+
+	void include(const std::vector<std::string> & keys, const int depth);
+	void exclude(const std::vector<std::string> & keys, const int depth);
+
+	// Returns true if the member with `key` in the object at `depth` should be parsed.
+	bool accept(const JsonStringView & key, const std::size_t depth) const;
+
+private:
+	Rule & getRule(const int depth);
+
+private:
+	Rule anyDepthRule;
+	std::vector<Rule> depthRuleList;
+};
+
+} // namespace internal_
+
+} // namespace jsonpp
+
+#endif
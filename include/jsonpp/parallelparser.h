@@ -0,0 +1,196 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_PARALLELPARSER_H_821598293712
+#define JSONPP_PARALLELPARSER_H_821598293712
+
+#include "jsonpp/parser.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+class WorkerPool;
+
+} // namespace internal_
+
+enum class ParallelOrder
+{
+	// The documents are passed to the callback in the same order as in the input.
+	inputOrder,
+	// The documents are passed to the callback as soon as they are parsed, the order among chunks is undetermined.
+	fastestFirst
+};
+
+// The result of each document in ParallelParser::parseBatch.
+struct BatchParseResult
+{
+	metapp::Variant value;
+	// Empty if the document is parsed successfully.
+	std::string errorMessage;
+};
+
+// The statistics of the last ParallelParser::parseBatch.
+struct BatchParseStats
+{
+	BatchParseStats()
+		:
+			documentCount(0),
+			failedCount(0),
+			byteCount(0),
+			threadCount(0),
+			elapsedTime(0),
+			parseTime(0),
+			maxDocumentTime(0)
+	{
+	}
+
+	std::size_t documentCount;
+	std::size_t failedCount;
+	// The total length of the documents.
+	std::size_t byteCount;
+	// The worker threads used, it's 1 if the batch is parsed in the calling thread.
+	std::size_t threadCount;
+	// The wall clock time of the whole batch.
+	std::chrono::nanoseconds elapsedTime;
+	// The time spent parsing the documents, summed over all threads.
+	// It's close to `elapsedTime * threadCount` if the work is spread evenly.
+	std::chrono::nanoseconds parseTime;
+	// The longest time spent parsing a single document.
+	std::chrono::nanoseconds maxDocumentTime;
+};
+
+// ParallelParser parses NDJSON (JSON Lines) with multiple threads.
+// The input is split at new line boundaries into chunks, each worker thread parses chunks with its own Parser.
+// Each document must be in a single line, which is required by NDJSON.
+// It also parses a batch of independent documents with multiple threads, see parseBatch.
+// The worker threads are started by the first call that needs them and are kept until the ParallelParser is destroyed.
+// The functions must not be called concurrently on the same ParallelParser.
+class ParallelParser
+{
+public:
+	ParallelParser();
+	// If threadCount is 0, std::thread::hardware_concurrency() is used.
+	explicit ParallelParser(const ParserConfig & config, const std::size_t threadCount = 0);
+	~ParallelParser();
+
+	std::size_t getThreadCount() const {
+		return threadCount;
+	}
+
+	ParallelOrder getOrder() const {
+		return order;
+	}
+
+	ParallelParser & setOrder(const ParallelOrder order_) {
+		order = order_;
+		return *this;
+	}
+
+	std::size_t getChunkSize() const {
+		return chunkSize;
+	}
+
+	// The approximate size in bytes of each chunk, default is 1MB.
+	ParallelParser & setChunkSize(const std::size_t chunkSize_) {
+		chunkSize = chunkSize_;
+		return *this;
+	}
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	// `callback` is never invoked concurrently, it's invoked in the calling thread for ParallelOrder::inputOrder,
+	// or in the worker threads for ParallelOrder::fastestFirst. It returns false to stop parsing.
+	// Returns true on success.
+	// The documents are buffered before they are passed to `callback`, so if `prototype` may hold JsonStringView,
+	// such as a field or an element of JsonStringView, parseMany fails without parsing. Use std::string instead.
+	bool parseMany(
+		const char * jsonText,
+		const std::size_t length,
+		const ParseManyCallback & callback,
+		const metapp::MetaType * prototype = nullptr
+	);
+	bool parseMany(const std::string & jsonText, const ParseManyCallback & callback, const metapp::MetaType * prototype = nullptr);
+
+	// `callback` has the prototype `bool callback(const T & value)`.
+	template <typename T, typename Callback>
+	bool parseMany(const char * jsonText, const std::size_t length, const Callback & callback) {
+		return parseMany(
+			jsonText,
+			length,
+			[&callback](const metapp::Variant & value) -> bool {
+				return callback(value.get<const T &>());
+			},
+			metapp::getMetaType<T>()
+		);
+	}
+
+	template <typename T, typename Callback>
+	bool parseMany(const std::string & jsonText, const Callback & callback) {
+		return parseMany<T>(jsonText.data(), jsonText.size(), callback);
+	}
+
+	// Parse `count` independent documents with the worker threads, each worker parses the next unparsed document.
+	// Returns the results in the same order as `sources`. A failed document doesn't stop the others,
+	// hasError() returns true if any document fails, and getError() returns the error of the first failed document.
+	// Each source is accessed by only one worker thread, don't access the sources in other threads during the call.
+	// Each worker parses many documents with the same Parser, so a JsonStringView in the result would refer to memory
+	// that is overwritten by the next document. If `prototype` may hold JsonStringView, such as a field or an element
+	// of JsonStringView, the batch is rejected, all results fail and nothing is parsed.
+	std::vector<BatchParseResult> parseBatch(
+		const ParserSource * sources,
+		const std::size_t count,
+		const metapp::MetaType * prototype = nullptr
+	);
+	std::vector<BatchParseResult> parseBatch(const std::vector<ParserSource> & sources, const metapp::MetaType * prototype = nullptr);
+
+	template <typename T>
+	std::vector<BatchParseResult> parseBatch(const std::vector<ParserSource> & sources) {
+		return parseBatch(sources, metapp::getMetaType<T>());
+	}
+
+	const BatchParseStats & getBatchStats() const {
+		return batchStats;
+	}
+
+private:
+	ParallelParser(const ParallelParser &) = delete;
+	ParallelParser & operator = (const ParallelParser &) = delete;
+
+	void prepareParsers(const std::size_t count);
+
+private:
+	ParserConfig config;
+	std::size_t threadCount;
+	ParallelOrder order;
+	std::size_t chunkSize;
+	// One parser for each worker thread, they are reused in each parseMany and parseBatch.
+	std::vector<std::unique_ptr<Parser> > parserList;
+	std::unique_ptr<internal_::WorkerPool> workerPool;
+	std::string errorMessage;
+	BatchParseStats batchStats;
+};
+
+
+} // namespace jsonpp
+
+#endif
@@ -18,11 +18,14 @@
 #define JSONPP_PARSER_H_821598293712
 
 #include "jsonpp/common.h"
+#include "jsonpp/document.h"
+#include "jsonpp/keyfilter.h"
 
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 
 namespace jsonpp {
 
@@ -30,6 +33,10 @@ enum class ParserBackendType
 {
 	simdjson,
 	cparser,
+	simdjsonOnDemand,
+	native,
+	// Choose the backend for each document by its size and shape, see AutoBackendThresholds.
+	automatic,
 };
 
 class ParserBackend;
@@ -41,6 +48,9 @@ using BackendCreator = std::unique_ptr<ParserBackend> (*)(const ParserConfig & c
 
 std::unique_ptr<ParserBackend> createBackend_cparser(const ParserConfig & config);
 std::unique_ptr<ParserBackend> createBackend_simdjsonDom(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_simdjsonOnDemand(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_native(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_automatic(const ParserConfig & config);
 
 template <ParserBackendType type>
 struct BackendCreatorGetter;
@@ -61,6 +71,30 @@ struct BackendCreatorGetter <ParserBackendType::cparser>
 	}
 };
 
+template <>
+struct BackendCreatorGetter <ParserBackendType::simdjsonOnDemand>
+{
+	static BackendCreator getCreator() {
+		return &createBackend_simdjsonOnDemand;
+	}
+};
+
+template <>
+struct BackendCreatorGetter <ParserBackendType::native>
+{
+	static BackendCreator getCreator() {
+		return &createBackend_native;
+	}
+};
+
+template <>
+struct BackendCreatorGetter <ParserBackendType::automatic>
+{
+	static BackendCreator getCreator() {
+		return &createBackend_automatic;
+	}
+};
+
 struct ScopedInvoke
 {
 	using Callback = std::function<void ()>;
@@ -79,6 +113,47 @@ struct ScopedInvoke
 
 class ParserBackend;
 
+// The callback for Parser::parseMany. Returns false to stop parsing.
+using ParseManyCallback = std::function<bool (const metapp::Variant & value)>;
+
+// The event handler for Parser::visit. The events are emitted in document order, no metapp::Variant is created.
+// The string views passed to onString and onKey are only valid during the call.
+// The default implementations do nothing, override the events that are needed.
+class ParserHandler
+{
+public:
+	virtual ~ParserHandler() {}
+
+	virtual void onNull() {}
+	virtual void onBool(const bool /*value*/) {}
+	virtual void onInt(const int64_t /*value*/) {}
+	virtual void onUint(const uint64_t /*value*/) {}
+	virtual void onDouble(const double /*value*/) {}
+	virtual void onString(const JsonStringView & /*value*/) {}
+	// `size` is the member count of the object.
+	virtual void onStartObject(const std::size_t /*size*/) {}
+	// Emitted before the value of each member.
+	virtual void onKey(const JsonStringView & /*key*/) {}
+	virtual void onEndObject() {}
+	// `size` is the element count of the array.
+	virtual void onStartArray(const std::size_t /*size*/) {}
+	virtual void onEndArray() {}
+};
+
+// The thresholds used by ParserBackendType::automatic to choose the backend for each document.
+// The documents shorter than `smallSize` bytes are parsed by backend cparser, which has the least setup cost.
+// The other documents are parsed by backend simdjson if they have at least `largeSize` bytes, or `largeSparseSize` bytes
+// if most of the sampled bytes are in strings or are white spaces, otherwise they are parsed by backend native.
+// The defaults are rough values for current x86-64 computers, use calibrateAutoBackend to measure them on the target machine.
+struct AutoBackendThresholds
+{
+	AutoBackendThresholds();
+
+	std::size_t smallSize;
+	std::size_t largeSize;
+	std::size_t largeSparseSize;
+};
+
 class ParserConfig
 {
 public:
@@ -125,6 +200,107 @@ public:
 		return *this;
 	}
 
+	std::size_t getBatchSize() const {
+		return batchSize;
+	}
+
+	// The batch size for Parser::parseMany, it must be larger than the largest document in the stream.
+	ParserConfig & setBatchSize(const std::size_t batchSize_) {
+		batchSize = batchSize_;
+		return *this;
+	}
+
+	bool allowZeroCopyString() const {
+		return zeroCopyString;
+	}
+
+	// If it's enabled, Parser::parseDocument doesn't copy the keys and strings, the document refers to the parser memory
+	// and keeps it alive. It's supported by backend simdjson, cparser and native, simdjsonOnDemand always copies.
+	ParserConfig & enableZeroCopyString(const bool enable) {
+		zeroCopyString = enable;
+		return *this;
+	}
+
+	const std::shared_ptr<StringPool> & getStringPool() const {
+		return stringPool;
+	}
+
+	// The string pool used by Parser::parseDocument if the document doesn't have its own pool.
+	ParserConfig & setStringPool(const std::shared_ptr<StringPool> & stringPool_) {
+		stringPool = stringPool_;
+		return *this;
+	}
+
+	std::size_t getInitialCapacity() const {
+		return initialCapacity;
+	}
+
+	// The document size in bytes that the simdjson and native backends allocate the buffers for when the parser is created,
+	// so the first parses don't allocate. The buffers still grow for larger documents. Default is 0.
+	ParserConfig & setInitialCapacity(const std::size_t initialCapacity_) {
+		initialCapacity = initialCapacity_;
+		return *this;
+	}
+
+	std::size_t getMaxCapacity() const {
+		return maxCapacity;
+	}
+
+	// The largest document size in bytes that the simdjson and native backends allocate the buffers for, parsing larger documents fails.
+	// 0 means the simdjson limit, which is 4GB. Default is 0.
+	ParserConfig & setMaxCapacity(const std::size_t maxCapacity_) {
+		maxCapacity = maxCapacity_;
+		return *this;
+	}
+
+	std::size_t getReleaseMemorySize() const {
+		return releaseMemorySize;
+	}
+
+	// Before each parse, if the parser holds more than `releaseMemorySize` bytes (see Parser::getMemorySize),
+	// the memory is released down to the initial capacity. It's not released right after the parse which grows it,
+	// so the JsonStringView values in the result stay valid until the next parse. 0 means never release, which is the default.
+	ParserConfig & setReleaseMemorySize(const std::size_t releaseMemorySize_) {
+		releaseMemorySize = releaseMemorySize_;
+		return *this;
+	}
+
+	const AutoBackendThresholds & getAutoThresholds() const {
+		return autoThresholds;
+	}
+
+	// The thresholds used by ParserBackendType::automatic.
+	ParserConfig & setAutoThresholds(const AutoBackendThresholds & autoThresholds_) {
+		autoThresholds = autoThresholds_;
+		return *this;
+	}
+
+	bool allowHugePages() const {
+		return hugePages;
+	}
+
+	// If it's enabled, the backend simdjson advises the kernel to back its buffers with transparent huge pages,
+	// which reduces TLB misses on large documents. It only works on Linux, and is ignored on the other systems.
+	ParserConfig & enableHugePages(const bool enable) {
+		hugePages = enable;
+		return *this;
+	}
+
+	static constexpr int anyDepth = internal_::KeyFilter::anyDepth;
+
+	// Returns nullptr if no keys are included or excluded.
+	const internal_::KeyFilter * getKeyFilter() const {
+		return keyFilter.get();
+	}
+
+	// Only the members with `keys` are parsed in the objects at `depth`, or at any depth if `depth` is anyDepth.
+	// The depth is the count of arrays and objects that contain the object, the root object has depth 0.
+	// It only applies to the objects parsed without prototype. The values of the skipped members are not converted.
+	ParserConfig & includeKeys(const std::vector<std::string> & keys, const int depth = anyDepth);
+	// The members with `keys` are skipped in the objects at `depth`, or at any depth if `depth` is anyDepth.
+	// Exclusion takes precedence over inclusion.
+	ParserConfig & excludeKeys(const std::vector<std::string> & keys, const int depth = anyDepth);
+
 	const metapp::MetaType * getObjectType() const {
 		return objectType;
 	}
@@ -138,6 +314,8 @@ public:
 		assert(
 			metapp::getNonReferenceMetaType(objectType_)->hasMetaMappable()
 			|| metapp::getNonReferenceMetaType(objectType_)->hasMetaIndexable()
+			|| objectType_ == metapp::getMetaType<JsonHashObject>()
+			|| objectType_ == metapp::getMetaType<JsonFlatObject>()
 		);
 
 		objectType = objectType_;
@@ -148,8 +326,18 @@ private:
 	ParserBackendType backendType;
 	internal_::BackendCreator backendCreator;
 	bool comment;
+	std::size_t batchSize;
+	bool zeroCopyString;
 	const metapp::MetaType * arrayType;
 	const metapp::MetaType * objectType;
+	std::shared_ptr<StringPool> stringPool;
+	std::size_t initialCapacity;
+	std::size_t maxCapacity;
+	std::size_t releaseMemorySize;
+	bool hugePages;
+	AutoBackendThresholds autoThresholds;
+	// Shared by the copies of the config, it's copied on write.
+	std::shared_ptr<internal_::KeyFilter> keyFilter;
 };
 
 class ParserSource
@@ -164,31 +352,40 @@ private:
 public:
 	ParserSource();
 	ParserSource(const char * cstr, const std::size_t cstrLength);
+	// `capacity` is the size of the readable memory starting from `cstr`, it must be >= `cstrLength`.
+	// If `capacity` covers the padding required by the parser backend, the text is parsed in place without copying.
+	ParserSource(const char * cstr, const std::size_t cstrLength, const std::size_t capacity);
 	explicit ParserSource(const std::string & str);
 	explicit ParserSource(std::string && str);
 
+	// The padding guaranteed by fromFile, it's enough for all parser backends.
+	static constexpr std::size_t filePadding = 64;
+
+	// Load the JSON document from file `fileName`. The file is memory mapped if the slack in the last page
+	// covers `filePadding`, otherwise it's read into a padded buffer, so the parser never copies the content again.
+	// If the file can't be read, the error is set in the source and is reported by the parser.
+	static ParserSource fromFile(const std::string & fileName);
+
 	const char * getText() const;
 	std::size_t getTextLength() const;
+	// The size of the readable memory starting from getText(), it's >= getTextLength().
 	std::size_t getCapacity() const;
 
 	void pad(const std::size_t size) const;
 
-private:
-	bool hasPrepared() const {
-		return prepared;
-	}
-
-	void setAsPrepared() const {
-		prepared = true;
-	}
+	bool hasError() const;
+	const std::string & getError() const;
 
 private:
-	mutable bool prepared;
 	mutable StorageType storageType;
 	mutable const char * cstr;
 	mutable std::size_t cstrLength;
+	mutable std::size_t cstrCapacity;
 	mutable const std::string * ref;
 	mutable std::string str;
+	// Keeps the memory of cstr alive, such as the mapped file.
+	mutable std::shared_ptr<const char> buffer;
+	std::string errorMessage;
 
 	friend class Parser;
 };
@@ -215,6 +412,12 @@ public:
 	bool hasError() const;
 	const std::string & getError() const;
 
+	// The approximate bytes held by the parser for reuse, they grow to fit the largest document parsed.
+	std::size_t getMemorySize() const;
+	// Release the memory held by the parser, the next parse allocates again.
+	// The JsonStringView values returned by the last parse become invalid.
+	void releaseMemory();
+
 	metapp::Variant parse(const char * jsonText, const std::size_t length, const metapp::MetaType * prototype = nullptr);
 	metapp::Variant parse(const std::string & jsonText, const metapp::MetaType * prototype = nullptr);
 	metapp::Variant parse(const ParserSource & source, const metapp::MetaType * prototype = nullptr);
@@ -252,13 +455,128 @@ public:
 		return result.get<const T &>();
 	}
 
+	// Parse into an existing object. The memory in `target`, such as the capacity of std::vector and std::string,
+	// is reused as much as possible. Returns true on success.
+	// On failure the value of `target` is unspecified, the values before the error may have been written into it,
+	// so it should be assigned or parsed again before it's used.
+	template <typename T>
+	bool parseInto(const char * jsonText, const std::size_t length, T & target) {
+		return parseInto(ParserSource(jsonText, length), target);
+	}
+
+	template <typename T>
+	bool parseInto(const std::string & jsonText, T & target) {
+		return parseInto(ParserSource(jsonText), target);
+	}
+
+	template <typename T>
+	bool parseInto(const ParserSource & source, T & target) {
+		static_assert(IsValidType<T>::value, "Type must be raw type without CV, reference, and array");
+
+		const metapp::Variant result = doParseInto(source, metapp::Variant::reference(target));
+		if(hasError()) {
+			return false;
+		}
+		if(! result.isEmpty()) {
+			target = result.get<const T &>();
+		}
+		return true;
+	}
+
+	// Parse into a JsonDocument which allocates all nodes from its own arena. The memory of `document` is reused.
+	// Returns true on success. On failure `document` is cleared.
+	bool parseDocument(const char * jsonText, const std::size_t length, JsonDocument & document);
+	bool parseDocument(const std::string & jsonText, JsonDocument & document);
+	bool parseDocument(const ParserSource & source, JsonDocument & document);
+
+	// Parse a stream of JSON documents separated by white spaces, such as NDJSON (JSON Lines).
+	// `callback` is invoked with each parsed document, and returns false to stop parsing.
+	// The JsonStringView values in a document are only valid during the callback, the backend may reuse
+	// the memory for the next document. Copy them, or use std::string, to keep them.
+	// Returns true on success.
+	bool parseMany(
+		const char * jsonText,
+		const std::size_t length,
+		const ParseManyCallback & callback,
+		const metapp::MetaType * prototype = nullptr
+	);
+	bool parseMany(const std::string & jsonText, const ParseManyCallback & callback, const metapp::MetaType * prototype = nullptr);
+	bool parseMany(const ParserSource & source, const ParseManyCallback & callback, const metapp::MetaType * prototype = nullptr);
+
+	// `callback` has the prototype `bool callback(const T & value)`.
+	template <typename T, typename Callback>
+	bool parseMany(const char * jsonText, const std::size_t length, const Callback & callback) {
+		return parseMany<T>(ParserSource(jsonText, length), callback);
+	}
+
+	template <typename T, typename Callback>
+	bool parseMany(const std::string & jsonText, const Callback & callback) {
+		return parseMany<T>(ParserSource(jsonText), callback);
+	}
+
+	template <typename T, typename Callback>
+	bool parseMany(const ParserSource & source, const Callback & callback) {
+		static_assert(IsValidType<T>::value, "Type must be raw type without CV, reference, and array");
+
+		return parseMany(
+			source,
+			[&callback](const metapp::Variant & value) -> bool {
+				return callback(value.get<const T &>());
+			},
+			metapp::getMetaType<T>()
+		);
+	}
+
+	// Extract the values at the RFC 6901 JSON Pointers, such as "/user/id", without converting the other values.
+	// `prototypes[i]` is the prototype for `pointers[i]`, missing or nullptr prototypes parse to the default types.
+	// Returns the values in the same order as `pointers`, a value is empty if it's not found.
+	// If there is any error, such as a malformed document or an invalid pointer, all values are empty.
+	// Backend simdjsonOnDemand and native don't validate the unmatched values.
+	std::vector<metapp::Variant> extract(
+		const char * jsonText,
+		const std::size_t length,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>()
+	);
+	std::vector<metapp::Variant> extract(
+		const std::string & jsonText,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>()
+	);
+	std::vector<metapp::Variant> extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>()
+	);
+
+	// Parse the document and pass the values to `handler` as events, without converting them to metapp::Variant.
+	// Returns true on success. On failure, the events before the error may have been emitted.
+	bool visit(const char * jsonText, const std::size_t length, ParserHandler & handler);
+	bool visit(const std::string & jsonText, ParserHandler & handler);
+	bool visit(const ParserSource & source, ParserHandler & handler);
+
+private:
+	metapp::Variant doParseInto(const ParserSource & source, const metapp::Variant & target);
+
+	template <typename Callback>
+	metapp::Variant doParse(const ParserSource & source, const Callback & callback);
+
 private:
 	std::unique_ptr<ParserBackend> backend;
+	std::size_t releaseMemorySize;
 	std::string errorMessage;
+	// The padded copy of the borrowed text that is not padded, it's reused across parses to avoid allocation.
+	std::string scratchBuffer;
 };
 
 std::string getParserBackendName(const ParserBackendType type);
 
+// Measure backend cparser, native and simdjson with generated documents on this machine, and return the thresholds
+// for ParserBackendType::automatic. It takes about one second, call it once at startup and cache the result.
+// The other settings in `config`, such as the array and object types, are used in the measurement.
+// The result is ordered, smallSize <= largeSparseSize <= largeSize, and each one is at most 2MB.
+AutoBackendThresholds calibrateAutoBackend(const ParserConfig & config = ParserConfig());
+
 } // namespace jsonpp
 
 #endif
@@ -17,6 +17,10 @@
 #ifndef JSONPP_PARSERBACKEND_H_821598293712
 #define JSONPP_PARSERBACKEND_H_821598293712
 
+#include "jsonpp/document.h"
+#include "jsonpp/stringpool.h"
+#include "jsonpp/enumcache.h"
+
 #include "metapp/variant.h"
 #include "metapp/allmetatypes.h"
 #include "metapp/interfaces/metaclass.h"
@@ -25,11 +29,456 @@
 #include "metapp/interfaces/metaenum.h"
 #include "metapp/compiler.h"
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <new>
 #include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace jsonpp {
 
+namespace internal_ {
+
+template <typename To, bool isFloat = std::is_floating_point<To>::value, bool isSigned = std::is_signed<To>::value>
+struct NumberRange;
+
+template <typename To, bool isSigned>
+struct NumberRange <To, true, isSigned>
+{
+	static bool contains(const int64_t /*value*/) {
+		return true;
+	}
+
+	static bool contains(const uint64_t /*value*/) {
+		return true;
+	}
+
+	static bool contains(const double value) {
+		// NaN and infinity are kept as is.
+		return value != value
+			|| value == std::numeric_limits<double>::infinity()
+			|| value == -std::numeric_limits<double>::infinity()
+			|| (value >= -(double)std::numeric_limits<To>::max() && value <= (double)std::numeric_limits<To>::max())
+		;
+	}
+};
+
+template <typename To>
+struct NumberRange <To, false, true>
+{
+	static bool contains(const int64_t value) {
+		return value >= (int64_t)std::numeric_limits<To>::min() && value <= (int64_t)std::numeric_limits<To>::max();
+	}
+
+	static bool contains(const uint64_t value) {
+		return value <= (uint64_t)std::numeric_limits<To>::max();
+	}
+
+	static bool contains(const double value) {
+		// For two's complement, max + 1 == -min, and -min is exact in double.
+		return value >= (double)std::numeric_limits<To>::min() && value < -(double)std::numeric_limits<To>::min();
+	}
+};
+
+template <typename To>
+struct NumberRange <To, false, false>
+{
+	static bool contains(const int64_t value) {
+		return value >= 0 && (uint64_t)value <= (uint64_t)std::numeric_limits<To>::max();
+	}
+
+	static bool contains(const uint64_t value) {
+		return value <= (uint64_t)std::numeric_limits<To>::max();
+	}
+
+	static bool contains(const double value) {
+		return value > -1.0 && value < (double)std::numeric_limits<To>::max() + 1.0;
+	}
+};
+
+template <typename To, typename From>
+void writeNumber(void * address, const From value)
+{
+	if(! NumberRange<To>::contains(value)) {
+		throw std::range_error("Number is out of range.");
+	}
+	*static_cast<To *>(address) = static_cast<To>(value);
+}
+
+// Returns true if typeKind is one of the types that writeScalar supports.
+inline bool isScalarTypeKind(const metapp::TypeKind typeKind)
+{
+	switch(typeKind) {
+	case metapp::getTypeKind<bool>():
+	case metapp::getTypeKind<char>():
+	case metapp::getTypeKind<signed char>():
+	case metapp::getTypeKind<unsigned char>():
+	case metapp::getTypeKind<short>():
+	case metapp::getTypeKind<unsigned short>():
+	case metapp::getTypeKind<int>():
+	case metapp::getTypeKind<unsigned int>():
+	case metapp::getTypeKind<long>():
+	case metapp::getTypeKind<unsigned long>():
+	case metapp::getTypeKind<long long>():
+	case metapp::getTypeKind<unsigned long long>():
+	case metapp::getTypeKind<float>():
+	case metapp::getTypeKind<double>():
+	case metapp::getTypeKind<std::string>():
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Write the number `value` to `address` which type is `typeKind`, the number is range checked.
+// typeKind must be a scalar type kind other than std::string.
+template <typename From>
+void writeScalar(const metapp::TypeKind typeKind, void * address, const From value)
+{
+	switch(typeKind) {
+	case metapp::getTypeKind<bool>():
+		*static_cast<bool *>(address) = (value != 0);
+		break;
+
+	case metapp::getTypeKind<char>():
+		writeNumber<char>(address, value);
+		break;
+
+	case metapp::getTypeKind<signed char>():
+		writeNumber<signed char>(address, value);
+		break;
+
+	case metapp::getTypeKind<unsigned char>():
+		writeNumber<unsigned char>(address, value);
+		break;
+
+	case metapp::getTypeKind<short>():
+		writeNumber<short>(address, value);
+		break;
+
+	case metapp::getTypeKind<unsigned short>():
+		writeNumber<unsigned short>(address, value);
+		break;
+
+	case metapp::getTypeKind<int>():
+		writeNumber<int>(address, value);
+		break;
+
+	case metapp::getTypeKind<unsigned int>():
+		writeNumber<unsigned int>(address, value);
+		break;
+
+	case metapp::getTypeKind<long>():
+		writeNumber<long>(address, value);
+		break;
+
+	case metapp::getTypeKind<unsigned long>():
+		writeNumber<unsigned long>(address, value);
+		break;
+
+	case metapp::getTypeKind<long long>():
+		writeNumber<long long>(address, value);
+		break;
+
+	case metapp::getTypeKind<unsigned long long>():
+		writeNumber<unsigned long long>(address, value);
+		break;
+
+	case metapp::getTypeKind<float>():
+		writeNumber<float>(address, value);
+		break;
+
+	case metapp::getTypeKind<double>():
+		writeNumber<double>(address, value);
+		break;
+
+	default:
+		break;
+	}
+}
+
+// Returns the address of the writable storage that `value` refers to, or nullptr if `value` is not a non-const reference.
+inline void * getWritableAddress(const metapp::Variant & value)
+{
+	const metapp::MetaType * metaType = value.getMetaType();
+	if(metaType->isReference() && ! metaType->getUpType()->isConst()) {
+		return value.getAddress();
+	}
+	return nullptr;
+}
+
+inline bool isJsonWhiteSpace(const char c)
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline std::size_t skipJsonWhiteSpaces(const char * text, const std::size_t length, std::size_t index)
+{
+	while(index < length && isJsonWhiteSpace(text[index])) {
+		++index;
+	}
+	return index;
+}
+
+// If `text[index]` starts a C style comment, returns the index after the comment, otherwise returns `index`.
+// An unclosed block comment extends to the end of `text`.
+inline std::size_t skipJsonComment(const char * text, const std::size_t length, const std::size_t index)
+{
+	if(index + 1 >= length || text[index] != '/') {
+		return index;
+	}
+	if(text[index + 1] == '/') {
+		const void * newLine = memchr(text + index + 2, '\n', length - index - 2);
+		return (newLine == nullptr ? length : static_cast<const char *>(newLine) - text + 1);
+	}
+	if(text[index + 1] == '*') {
+		for(std::size_t i = index + 2; i + 1 < length; ++i) {
+			if(text[i] == '*' && text[i + 1] == '/') {
+				return i + 2;
+			}
+		}
+		return length;
+	}
+	return index;
+}
+
+// Skip the white spaces, and the comments if `allowComment` is true.
+inline std::size_t skipJsonSeparators(const char * text, const std::size_t length, std::size_t index, const bool allowComment)
+{
+	for(;;) {
+		index = skipJsonWhiteSpaces(text, length, index);
+		if(! allowComment) {
+			return index;
+		}
+		const std::size_t next = skipJsonComment(text, length, index);
+		if(next == index) {
+			return index;
+		}
+		index = next;
+	}
+}
+
+// Split `text` into top level JSON values separated by white spaces, for the backends that can't parse a stream natively.
+// Only strings, brackets and, if `allowComment` is true, comments are tracked,
+// the values are validated by the backend when they are parsed.
+// callback(begin, end) is invoked for each value, and returns false to stop.
+template <typename Callback>
+void splitJsonDocuments(const char * text, const std::size_t length, const bool allowComment, const Callback & callback)
+{
+	std::size_t begin = skipJsonSeparators(text, length, 0, allowComment);
+	while(begin < length) {
+		std::size_t end = begin;
+		int depth = 0;
+		bool inString = false;
+		for(; end < length; ++end) {
+			const char c = text[end];
+			if(inString) {
+				if(c == '\\') {
+					++end;
+				}
+				else if(c == '"') {
+					inString = false;
+					if(depth == 0) {
+						++end;
+						break;
+					}
+				}
+			}
+			else if(c == '"') {
+				inString = true;
+			}
+			else if(c == '{' || c == '[') {
+				++depth;
+			}
+			else if(c == '}' || c == ']') {
+				--depth;
+				if(depth <= 0) {
+					++end;
+					break;
+				}
+			}
+			else if(depth == 0 && isJsonWhiteSpace(c)) {
+				break;
+			}
+			else if(allowComment && c == '/') {
+				const std::size_t next = skipJsonComment(text, length, end);
+				if(next != end) {
+					// A comment ends the top level scalar, such as `5// note`.
+					if(depth == 0) {
+						break;
+					}
+					end = next - 1;
+				}
+			}
+		}
+		if(end > length) {
+			end = length;
+		}
+		if(! callback(begin, end)) {
+			return;
+		}
+		begin = skipJsonSeparators(text, length, end, allowComment);
+	}
+}
+
+// Split the RFC 6901 JSON Pointer into reference tokens, "~1" is unescaped to '/', and "~0" to '~'.
+// callback(token) is invoked for each token, and returns false to stop.
+// Returns false if the pointer is invalid, i.e, it's not empty and doesn't start with '/', or has invalid escape.
+template <typename Callback>
+bool iterateJsonPointer(const std::string & pointer, const Callback & callback)
+{
+	if(pointer.empty()) {
+		return true;
+	}
+	if(pointer[0] != '/') {
+		return false;
+	}
+	std::string token;
+	std::size_t index = 1;
+	for(;;) {
+		token.clear();
+		while(index < pointer.size() && pointer[index] != '/') {
+			char c = pointer[index];
+			if(c == '~') {
+				++index;
+				if(index >= pointer.size() || (pointer[index] != '0' && pointer[index] != '1')) {
+					return false;
+				}
+				c = (pointer[index] == '0' ? '~' : '/');
+			}
+			token.push_back(c);
+			++index;
+		}
+		if(! callback(token)) {
+			break;
+		}
+		if(index >= pointer.size()) {
+			break;
+		}
+		++index;
+	}
+	return true;
+}
+
+// Convert the JSON Pointer reference token to array index. Leading zeros and "-" are not valid index.
+inline bool getJsonPointerIndex(const std::string & token, std::size_t & index)
+{
+	if(token.empty() || token.size() > 18 || (token[0] == '0' && token.size() > 1)) {
+		return false;
+	}
+	index = 0;
+	for(const char c : token) {
+		if(c < '0' || c > '9') {
+			return false;
+		}
+		index = index * 10 + static_cast<std::size_t>(c - '0');
+	}
+	return true;
+}
+
+// Sort the members by key. For duplicated keys, the first member is kept, the same as JsonObject.
+inline void sortFlatObject(JsonFlatObject & object)
+{
+	using Member = JsonFlatObject::value_type;
+	const auto lessKey = [](const Member & a, const Member & b) -> bool {
+		return a.first < b.first;
+	};
+	const auto sameKey = [](const Member & a, const Member & b) -> bool {
+		return a.first == b.first;
+	};
+	// JSON producers often emit sorted keys, then there is no need to sort.
+	if(! std::is_sorted(object.begin(), object.end(), lessKey)) {
+		std::stable_sort(object.begin(), object.end(), lessKey);
+	}
+	object.erase(std::unique(object.begin(), object.end(), sameKey), object.end());
+}
+
+// ClassParsePlan is built once for each MetaClass, and shared by all parsers.
+// It holds the fields in declaration order, with the resolved value type, and a hash table to find the fields by name.
+class ClassParsePlan
+{
+public:
+	struct Field
+	{
+		std::string name;
+		metapp::Variant accessible;
+		const metapp::MetaType * valueType;
+		// True if the value type can be written by writeScalar directly.
+		bool scalar;
+	};
+
+public:
+	explicit ClassParsePlan(const metapp::MetaClass * metaClass);
+
+	// nextIndex is the index of the field that's expected to be the next key.
+	// JSON producers usually emit the keys in declaration order, so the expected field is tried before the hash table.
+	// nextIndex should be 0 before the first key of an object, and it's updated on each call.
+	const Field * findField(const char * key, const std::size_t keyLength, std::size_t & nextIndex) const {
+		if(nextIndex < fieldList.size() && isFieldName(fieldList[nextIndex], key, keyLength)) {
+			return &fieldList[nextIndex++];
+		}
+		if(slotList.empty()) {
+			return nullptr;
+		}
+		std::size_t slot = static_cast<std::size_t>(hashKey(key, keyLength)) & slotMask;
+		for(;;) {
+			const uint32_t fieldIndex = slotList[slot];
+			if(fieldIndex == 0) {
+				return nullptr;
+			}
+			if(isFieldName(fieldList[fieldIndex - 1], key, keyLength)) {
+				nextIndex = fieldIndex;
+				return &fieldList[fieldIndex - 1];
+			}
+			slot = (slot + 1) & slotMask;
+		}
+	}
+
+	const std::vector<Field> & getFieldList() const {
+		return fieldList;
+	}
+
+private:
+	static bool isFieldName(const Field & field, const char * key, const std::size_t keyLength) {
+		return field.name.size() == keyLength && memcmp(field.name.data(), key, keyLength) == 0;
+	}
+
+private:
+	std::vector<Field> fieldList;
+	// Open addressing table, each slot is the field index + 1, 0 means empty slot.
+	std::vector<uint32_t> slotList;
+	std::size_t slotMask;
+};
+
+// Returns the cached plan for metaClass, the plan is created on first call. It's thread safe,
+// and it only locks the first time each thread looks up the class.
+const ClassParsePlan * getClassParsePlan(const metapp::MetaClass * metaClass);
+
+// NumericArrayLayout describes the std::vector which elements are numbers, or std::array of numbers,
+// such as std::vector<double> or std::vector<std::array<double, 2> >. The numbers are stored contiguously,
+// so they can be written to the vector storage directly, without creating Variant for each element.
+struct NumericArrayLayout
+{
+	// The type kind of the numbers, it's a scalar type kind other than bool and std::string.
+	metapp::TypeKind numberTypeKind;
+	// The count of numbers in each element, which is the size of the std::array, or 0 if the element is a number.
+	std::size_t groupSize;
+};
+
+// Returns the cached layout for metaType, or nullptr if metaType doesn't have the numeric layout.
+// The layout is created on first call. Like getClassParsePlan, it only locks the first time each thread looks up the type.
+const NumericArrayLayout * getNumericArrayLayout(const metapp::MetaType * metaType);
+
+} // namespace internal_
+
 struct ParserBackendResult
 {
 	metapp::Variant value;
@@ -43,12 +492,73 @@ public:
 
 	virtual ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) = 0;
 
-	virtual void prepareSource(const ParserSource & /*source*/) const {
+	// Parse into the object that `target` refers to. See GeneralParser::parseInto for the returned value.
+	virtual ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) = 0;
+
+	// Parse into `document`. The returned value is always empty.
+	virtual ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) = 0;
+
+	// Parse the documents separated by white spaces in `source`, and pass each one to `callback`.
+	// The returned value is always empty.
+	virtual ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) = 0;
+
+	// Find the values at the JSON Pointers, and convert them to the prototypes. `results`, `pointers` and `prototypes`
+	// have the same size, and the pointers are valid. The values not found are left empty in `results`.
+	// The returned value is always empty.
+	virtual ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) = 0;
+
+	// Pass the values in the document to `handler` as events. The returned value is always empty.
+	virtual ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) = 0;
+
+	// The approximate bytes held by the backend, they usually grow to fit the largest document parsed.
+	virtual std::size_t getMemorySize() const {
+		return 0;
+	}
+
+	// Release the memory held by the backend, the next parse allocates again.
+	virtual void releaseMemory() {
+	}
+
+	// The bytes after the text that must be readable by the backend.
+	virtual std::size_t getPadding() const {
+		return 0;
 	}
 
 private:
 };
 
+namespace internal_ {
+
+// Returns the element count if the backend knows it without scanning the array, otherwise 0.
+// The containers are sized to the hint first, then grow while the elements are appended.
+template <typename Implement>
+std::size_t getArraySizeHint(const Implement & implement, typename Implement::Array & array)
+{
+	return Implement::knowsContainerSize ? implement.getArraySize(array) : 0;
+}
+
+template <typename Implement>
+std::size_t getObjectSizeHint(const Implement & implement, typename Implement::Object & object)
+{
+	return Implement::knowsContainerSize ? implement.getObjectSize(object) : 0;
+}
+
+} // namespace internal_
+
+// Implement provides the node access of a backend. The strings and object keys are passed as JsonStringView
+// (getStringView, and the key argument of the iterateObject callback) which refer to the backend memory,
+// so a std::string is only created when the parsed value stores one.
+// If `Implement::knowsContainerSize` is false, getArraySize and getObjectSize need to scan the container,
+// so they are not used for the conversion, the containers grow while the elements are appended.
 template <typename Implement>
 class GeneralParser
 {
@@ -60,20 +570,160 @@ private:
 
 public:
 	GeneralParser(const ParserConfig & config, const Implement & implement)
-		: config(config), implement(implement)
+		:
+			config(config),
+			implement(implement),
+			cachedMetaClass(nullptr),
+			cachedClassParsePlan(nullptr),
+			cachedArrayType(nullptr),
+			cachedNumericArrayLayout(nullptr),
+			enumCacheList(),
+			keyFilter(config.getKeyFilter()),
+			depth(0)
 	{}
 
 	template <typename T>
 	metapp::Variant parse(T && node, const metapp::MetaType * prototype)
 	{
+		prototype = normalizePrototype(prototype);
+		const auto nodeType = implement.getNodeType(std::forward<T>(node));
+		if(prototype != nullptr && canWriteScalar(nodeType, prototype)) {
+			metapp::Variant result(prototype, nullptr);
+			doWriteScalar(std::forward<T>(node), nodeType, prototype->getTypeKind(), result.getAddress());
+			return result;
+		}
+		return doParse(std::forward<T>(node), nodeType, prototype);
+	}
+
+	// Parse the node into the existing object that `target` refers to, the memory in the object, such as the capacity
+	// of std::vector and std::string, is reused as much as possible.
+	// Returns empty Variant if the node is written into the object. Otherwise the object can't be written in place,
+	// such as `target` is not a reference, then the parsed value is returned and the caller should assign it to the object.
+	// Class fields that don't appear in the JSON object keep their previous values.
+	template <typename T>
+	metapp::Variant parseInto(T && node, const metapp::Variant & target)
+	{
+		const metapp::MetaType * type = normalizePrototype(target.getMetaType());
+		const auto nodeType = implement.getNodeType(std::forward<T>(node));
+		void * address = internal_::getWritableAddress(target);
+		if(type != nullptr && address != nullptr) {
+			if(canWriteScalar(nodeType, type)) {
+				doWriteScalar(std::forward<T>(node), nodeType, type->getTypeKind(), address);
+				return metapp::Variant();
+			}
+			if(nodeType == Implement::typeArray) {
+				const metapp::MetaIndexable * metaIndexable = type->getMetaIndexable();
+				if(metaIndexable != nullptr) {
+					doConvertArrayInto(std::forward<T>(node), target, metaIndexable);
+					return metapp::Variant();
+				}
+			}
+			// Mappable types (std::map, etc) are not parsed in place, they are parsed then assigned,
+			// the assignment of STL containers reuses the allocated nodes.
+			if(nodeType == Implement::typeObject
+				&& ! type->hasMetaMappable()
+				&& ! type->hasMetaIndexable()
+			) {
+				const metapp::MetaClass * metaClass = type->getMetaClass();
+				if(metaClass != nullptr) {
+					doConvertClassInto(std::forward<T>(node), target, metaClass);
+					return metapp::Variant();
+				}
+			}
+		}
+		return doParse(std::forward<T>(node), nodeType, type);
+	}
+
+private:
+	// Counts the arrays and objects being converted.
+	struct DepthGuard
+	{
+		explicit DepthGuard(std::size_t & depth) : depth(depth) {
+			++depth;
+		}
+
+		~DepthGuard() {
+			--depth;
+		}
+
+		std::size_t & depth;
+	};
+
+	static const metapp::MetaType * normalizePrototype(const metapp::MetaType * prototype) {
 		if(prototype != nullptr) {
 			prototype = metapp::getNonReferenceMetaType(prototype);
 			if(prototype->getTypeKind() == metapp::tkVariant) {
 				prototype = nullptr;
 			}
 		}
+		return prototype;
+	}
+
+	// Returns true if the node can be written to the storage of `type` directly by doWriteScalar.
+	// It only checks the types, so the node is not consumed.
+	template <typename NodeType>
+	static bool canWriteScalar(const NodeType nodeType, const metapp::MetaType * type) {
+		const auto typeKind = type->getTypeKind();
+		if(! internal_::isScalarTypeKind(typeKind)) {
+			return false;
+		}
+		if(nodeType == Implement::typeString) {
+			return typeKind == metapp::tkStdString;
+		}
+		return typeKind != metapp::tkStdString
+			&& (
+				nodeType == Implement::typeBoolean
+				|| nodeType == Implement::typeInteger
+				|| nodeType == Implement::typeUnsignedInteger
+				|| nodeType == Implement::typeDouble
+			)
+		;
+	}
+
+	// Write the scalar node to `address` without creating any intermediate Variant.
+	// canWriteScalar must return true before calling this function.
+	template <typename T, typename NodeType>
+	void doWriteScalar(T && node, const NodeType nodeType, const metapp::TypeKind typeKind, void * address) {
+		if(nodeType == Implement::typeString) {
+			// assign reuses the capacity of the existing string.
+			const JsonStringView s = implement.getStringView(std::forward<T>(node));
+			static_cast<JsonString *>(address)->assign(s.data(), s.size());
+		}
+		else if(nodeType == Implement::typeBoolean) {
+			internal_::writeScalar(typeKind, address, (JsonInt)(implement.getBoolean(std::forward<T>(node)) ? 1 : 0));
+		}
+		else if(nodeType == Implement::typeInteger) {
+			internal_::writeScalar(typeKind, address, (JsonInt)(implement.getInteger(std::forward<T>(node))));
+		}
+		else if(nodeType == Implement::typeUnsignedInteger) {
+			internal_::writeScalar(typeKind, address, (JsonUnsignedInt)(implement.getUnsignedInteger(std::forward<T>(node))));
+		}
+		else {
+			internal_::writeScalar(typeKind, address, (JsonReal)(implement.getDouble(std::forward<T>(node))));
+		}
+	}
+
+	// Parse the node and write it to the storage that `target` refers to. If `target` is not a writable reference,
+	// the parsed value is passed to `setter`.
+	// `prototype` must be normalized.
+	template <typename T, typename Setter>
+	void doParseInto(T && node, const metapp::MetaType * prototype, const metapp::Variant & target, const Setter & setter) {
+		const auto nodeType = implement.getNodeType(std::forward<T>(node));
+		if(prototype != nullptr && canWriteScalar(nodeType, prototype)) {
+			void * address = internal_::getWritableAddress(target);
+			if(address != nullptr) {
+				doWriteScalar(std::forward<T>(node), nodeType, prototype->getTypeKind(), address);
+				return;
+			}
+		}
+		setter(doParse(std::forward<T>(node), nodeType, prototype));
+	}
 
-		switch(implement.getNodeType(std::forward<T>(node))) {
+	// `prototype` must be normalized.
+	template <typename T, typename NodeType>
+	metapp::Variant doParse(T && node, const NodeType nodeType, const metapp::MetaType * prototype)
+	{
+		switch(nodeType) {
 		case Implement::typeNull:
 			if(prototype != nullptr) {
 				return metapp::Variant(nullptr).cast(prototype);
@@ -106,29 +756,38 @@ public:
 
 		case Implement::typeString: {
 			if(prototype != nullptr) {
+				// The view refers to the parser memory, it's valid until the next parse.
+				if(prototype == metapp::getMetaType<JsonStringView>()) {
+					return metapp::Variant(implement.getStringView(std::forward<T>(node)));
+				}
 				if(prototype->isEnum()) {
 					const auto metaEnum = prototype->getMetaEnum();
 					if(metaEnum != nullptr) {
-						const auto & metaItem = metaEnum->getByName(JsonString(implement.getString(std::forward<T>(node))));
+						const JsonStringView name = implement.getStringView(std::forward<T>(node));
+						const internal_::EnumCache::Item * item = enumCacheList.get(metaEnum)->findByName(name.data(), name.size());
 						metapp::Variant enumValue = 0;
-						if(! metaItem.isEmpty()) {
-							enumValue = metaItem.asEnumValue().cast<long long>();
+						if(item != nullptr) {
+							enumValue = item->value;
 						}
 						// There is a dedicated item in metapp FAQ for this conversion.
 						return enumValue.cast(prototype);
 					}
 					return metapp::Variant(prototype, nullptr);
 				}
-				return metapp::Variant(JsonString(implement.getString(std::forward<T>(node)))).cast(prototype);
+				return metapp::Variant(implement.getStringView(std::forward<T>(node)).toString()).cast(prototype);
 			}
-			return JsonString(implement.getString(std::forward<T>(node)));
+			return implement.getStringView(std::forward<T>(node)).toString();
 		}
 
-		case Implement::typeArray:
+		case Implement::typeArray: {
+			const DepthGuard guard(depth);
 			return doConvertArray(std::forward<T>(node), prototype);
+		}
 
-		case Implement::typeObject:
+		case Implement::typeObject: {
+			const DepthGuard guard(depth);
 			return doConvertObject(std::forward<T>(node), prototype);
+		}
 
 		default:
 			break;
@@ -136,7 +795,6 @@ public:
 		return metapp::Variant();
 	}
 
-private:
 	template <typename T>
 	metapp::Variant doConvertArray(T && node, const metapp::MetaType * prototype)
 	{
@@ -150,11 +808,12 @@ private:
 			// Parsing canada.json speeds up more than 30%, citm_catalog.json and twitter.json more than 60%~70%.
 			// The same for doConvertObject.
 			Array array = implement.getArray(std::forward<T>(node));
-			JsonArray result(implement.getArraySize(array));
+			JsonArray result;
+			result.reserve(internal_::getArraySizeHint(implement, array));
 			implement.iterateArray(
 				array,
-				[this, &result](const std::size_t index, ArrayValue arrayValue) -> void {
-					result[index] = parse(arrayValue, nullptr);
+				[this, &result](const std::size_t /*index*/, ArrayValue arrayValue) -> void {
+					result.push_back(parse(arrayValue, nullptr));
 				}
 			);
 			return result;
@@ -163,15 +822,36 @@ private:
 			metapp::Variant result = metapp::Variant(type, nullptr);
 			auto metaIndexable = metapp::getNonReferenceMetaType(result)->getMetaIndexable();
 			Array array = implement.getArray(std::forward<T>(node));
-			metaIndexable->resize(result, implement.getArraySize(array));
+			std::size_t size = internal_::getArraySizeHint(implement, array);
+			metaIndexable->resize(result, size);
+			if(prototype != nullptr) {
+				const internal_::NumericArrayLayout * layout = getNumericArrayLayout(type);
+				if(layout != nullptr) {
+					doFillNumericArray(array, size, *layout, result, metaIndexable);
+					return result;
+				}
+			}
 			implement.iterateArray(
 				array,
-				[this, metaIndexable, prototype, &result](const std::size_t index, ArrayValue arrayValue) -> void {
+				[this, metaIndexable, prototype, &result, &size](const std::size_t index, ArrayValue arrayValue) -> void {
+					growIndexable(result, metaIndexable, index, size);
 					const metapp::MetaType * elementProto = nullptr;
 					if(prototype != nullptr) {
-						elementProto = metapp::getNonReferenceMetaType(metaIndexable->getValueType(result, index));
+						elementProto = normalizePrototype(metaIndexable->getValueType(result, index));
+					}
+					if(elementProto != nullptr && internal_::isScalarTypeKind(elementProto->getTypeKind())) {
+						doParseInto(
+							arrayValue,
+							elementProto,
+							metaIndexable->get(result, index),
+							[metaIndexable, index, &result](const metapp::Variant & value) {
+								metaIndexable->set(result, index, value);
+							}
+						);
+					}
+					else {
+						metaIndexable->set(result, index, parse(arrayValue, elementProto));
 					}
-					metaIndexable->set(result, index, parse(arrayValue, elementProto));
 				}
 			);
 			return result;
@@ -189,17 +869,50 @@ private:
 		if(type == nullptr) {
 			type = config.getObjectType();
 		}
+		// The key filter only applies to the objects parsed without prototype.
+		const bool filterKeys = (prototype == nullptr && keyFilter != nullptr);
 		if(type == nullptr) {
 			Object object = implement.getObject(std::forward<T>(node));
 			JsonObject result;
 			implement.iterateObject(
 				object,
-				[this, &result](const std::string & key, ObjectValue objectValue) -> void {
-					result.insert(std::make_pair(key, parse(objectValue, nullptr)));
+				[this, &result, filterKeys](const JsonStringView & key, ObjectValue objectValue) -> void {
+					if(! skipKey(filterKeys, key)) {
+						result.insert(std::make_pair(key.toString(), parse(objectValue, nullptr)));
+					}
 				}
 			);
 			return result;
 		}
+		else if(type == metapp::getMetaType<JsonHashObject>()) {
+			Object object = implement.getObject(std::forward<T>(node));
+			JsonHashObject result;
+			result.reserve(internal_::getObjectSizeHint(implement, object));
+			implement.iterateObject(
+				object,
+				[this, &result, filterKeys](const JsonStringView & key, ObjectValue objectValue) -> void {
+					if(! skipKey(filterKeys, key)) {
+						result.insert(JsonHashObject::value_type(key.toString(), parse(objectValue, nullptr)));
+					}
+				}
+			);
+			return metapp::Variant(std::move(result));
+		}
+		else if(type == metapp::getMetaType<JsonFlatObject>()) {
+			Object object = implement.getObject(std::forward<T>(node));
+			JsonFlatObject result;
+			result.reserve(internal_::getObjectSizeHint(implement, object));
+			implement.iterateObject(
+				object,
+				[this, &result, filterKeys](const JsonStringView & key, ObjectValue objectValue) -> void {
+					if(! skipKey(filterKeys, key)) {
+						result.emplace_back(key.toString(), parse(objectValue, nullptr));
+					}
+				}
+			);
+			internal_::sortFlatObject(result);
+			return metapp::Variant(std::move(result));
+		}
 		else {
 			const metapp::MetaMappable * metaMappable = type->getMetaMappable();
 			const metapp::MetaIndexable * metaIndexable = type->getMetaIndexable();
@@ -210,26 +923,34 @@ private:
 				auto valueType = metaMappable->getValueType(result);
 				implement.iterateObject(
 					object,
-					[this, &result, metaMappable, valueType](const std::string & key, ObjectValue objectValue) -> void {
+					[this, &result, metaMappable, valueType, filterKeys](const JsonStringView & key, ObjectValue objectValue) -> void {
+						if(skipKey(filterKeys, key)) {
+							return;
+						}
 						metaMappable->set(
 							result,
-							key,
+							key.toString(),
 							parse(objectValue, valueType->getUpType(1))
 						);
 					}
 				);
 			}
 			else if(metaIndexable != nullptr) {
-				metaIndexable->resize(result, implement.getObjectSize(object));
+				std::size_t size = internal_::getObjectSizeHint(implement, object);
+				metaIndexable->resize(result, size);
 				std::size_t index = 0;
 				implement.iterateObject(
 					object,
-					[this, &index, &result, metaIndexable](const std::string & key, ObjectValue objectValue) -> void {
+					[this, &index, &size, &result, metaIndexable, filterKeys](const JsonStringView & key, ObjectValue objectValue) -> void {
+						if(skipKey(filterKeys, key)) {
+							return;
+						}
+						growIndexable(result, metaIndexable, index, size);
 						const auto value = metaIndexable->get(result, index);
 						auto valueIndexable = metapp::getNonReferenceMetaType(value)->getMetaIndexable();
 						if(valueIndexable != nullptr) {
 							valueIndexable->resize(value, 2);
-							valueIndexable->set(value, 0, key);
+							valueIndexable->set(value, 0, key.toString());
 							valueIndexable->set(
 								value,
 								1,
@@ -239,19 +960,34 @@ private:
 						++index;
 					}
 				);
+				if(index < size) {
+					metaIndexable->resize(result, index);
+				}
 			}
 			else if(metaClass != nullptr) {
+				const internal_::ClassParsePlan * plan = getClassParsePlan(metaClass);
+				std::size_t nextIndex = 0;
 				implement.iterateObject(
 					object,
-					[this, &result, metaClass](const std::string & key, ObjectValue objectValue) -> void {
-						const auto & field = metaClass->getAccessible(key);
-						if(! field.isEmpty()) {
-							metapp::accessibleSet(
-								field,
-								result.getAddress(),
-								parse(objectValue, metapp::accessibleGetValueType(field))
+					[this, &result, plan, &nextIndex](const JsonStringView & key, ObjectValue objectValue) -> void {
+						const auto field = plan->findField(key.data(), key.size(), nextIndex);
+						if(field == nullptr) {
+							return;
+						}
+						const auto setter = [field, &result](const metapp::Variant & value) {
+							metapp::accessibleSet(field->accessible, result.getAddress(), value);
+						};
+						if(field->scalar) {
+							doParseInto(
+								objectValue,
+								normalizePrototype(field->valueType),
+								metapp::accessibleGet(field->accessible, result.getAddress()),
+								setter
 							);
 						}
+						else {
+							setter(parse(objectValue, field->valueType));
+						}
 					}
 				);
 			}
@@ -259,11 +995,694 @@ private:
 		}
 	}
 
+	template <typename T>
+	void doConvertArrayInto(T && node, const metapp::Variant & target, const metapp::MetaIndexable * metaIndexable)
+	{
+		const DepthGuard guard(depth);
+		Array array = implement.getArray(std::forward<T>(node));
+		// If the size is not known, the existing elements are kept to be reused, the extra ones are removed at last.
+		std::size_t size = (Implement::knowsContainerSize
+			? implement.getArraySize(array)
+			: metaIndexable->getSizeInfo(target).getSize()
+		);
+		metaIndexable->resize(target, size);
+		const internal_::NumericArrayLayout * layout = getNumericArrayLayout(normalizePrototype(target.getMetaType()));
+		if(layout != nullptr) {
+			doFillNumericArray(array, size, *layout, target, metaIndexable);
+			return;
+		}
+		std::size_t count = 0;
+		implement.iterateArray(
+			array,
+			[this, metaIndexable, &target, &size, &count](const std::size_t index, ArrayValue arrayValue) -> void {
+				growIndexable(target, metaIndexable, index, size);
+				count = index + 1;
+				const metapp::Variant value = parseInto(arrayValue, metaIndexable->get(target, index));
+				if(! value.isEmpty()) {
+					metaIndexable->set(target, index, value);
+				}
+			}
+		);
+		if(count < size) {
+			metaIndexable->resize(target, count);
+		}
+	}
+
+	template <typename T>
+	void doConvertClassInto(T && node, const metapp::Variant & target, const metapp::MetaClass * metaClass)
+	{
+		const DepthGuard guard(depth);
+		Object object = implement.getObject(std::forward<T>(node));
+		const internal_::ClassParsePlan * plan = getClassParsePlan(metaClass);
+		std::size_t nextIndex = 0;
+		implement.iterateObject(
+			object,
+			[this, &target, plan, &nextIndex](const JsonStringView & key, ObjectValue objectValue) -> void {
+				const auto field = plan->findField(key.data(), key.size(), nextIndex);
+				if(field == nullptr) {
+					return;
+				}
+				const metapp::Variant value = parseInto(
+					objectValue,
+					metapp::accessibleGet(field->accessible, target.getAddress())
+				);
+				if(! value.isEmpty()) {
+					metapp::accessibleSet(field->accessible, target.getAddress(), value);
+				}
+			}
+		);
+	}
+
+	// Write the numbers in `array` to the storage of `container` directly, the layout of `container` is `layout`.
+	// `container` is already resized to `size`. If the size of `array` is not known, `container` grows and shrinks to fit.
+	void doFillNumericArray(
+			Array & array,
+			const std::size_t size,
+			const internal_::NumericArrayLayout & layout,
+			const metapp::Variant & container,
+			const metapp::MetaIndexable * metaIndexable
+		)
+	{
+		switch(layout.numberTypeKind) {
+		case metapp::getTypeKind<char>():
+			doFillNumbers<char>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<signed char>():
+			doFillNumbers<signed char>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<unsigned char>():
+			doFillNumbers<unsigned char>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<short>():
+			doFillNumbers<short>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<unsigned short>():
+			doFillNumbers<unsigned short>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<int>():
+			doFillNumbers<int>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<unsigned int>():
+			doFillNumbers<unsigned int>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<long>():
+			doFillNumbers<long>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<unsigned long>():
+			doFillNumbers<unsigned long>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<long long>():
+			doFillNumbers<long long>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<unsigned long long>():
+			doFillNumbers<unsigned long long>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<float>():
+			doFillNumbers<float>(array, size, layout, container, metaIndexable);
+			break;
+
+		case metapp::getTypeKind<double>():
+			doFillNumbers<double>(array, size, layout, container, metaIndexable);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// The values that are not numbers, such as null or a nested object, are converted by the general path,
+	// so the result is the same as converting the elements one by one.
+	// If the size is not known before iterating, `container` grows by doubling, then shrinks to the element count.
+	template <typename To>
+	void doFillNumbers(
+			Array & array,
+			std::size_t size,
+			const internal_::NumericArrayLayout & layout,
+			const metapp::Variant & container,
+			const metapp::MetaIndexable * metaIndexable
+		)
+	{
+		To * data = (size > 0 ? getNumberData<To>(container, metaIndexable) : nullptr);
+		std::size_t count = 0;
+		const auto prepare = [&data, &size, &count, &container, metaIndexable](const std::size_t index) {
+			if(index >= size) {
+				size = (std::max)(index + 1, size * 2);
+				metaIndexable->resize(container, size);
+				data = getNumberData<To>(container, metaIndexable);
+			}
+			count = index + 1;
+		};
+		const std::size_t groupSize = layout.groupSize;
+		if(groupSize == 0) {
+			implement.iterateArray(
+				array,
+				[this, &prepare, &data, &container, metaIndexable](const std::size_t index, ArrayValue arrayValue) -> void {
+					prepare(index);
+					const auto nodeType = implement.getNodeType(arrayValue);
+					if(! doWriteNumber(arrayValue, nodeType, data + index)) {
+						metaIndexable->set(container, index, doParse(arrayValue, nodeType, metapp::getMetaType<To>()));
+					}
+				}
+			);
+		}
+		else {
+			implement.iterateArray(
+				array,
+				[this, &prepare, &data, groupSize, &container, metaIndexable](const std::size_t index, ArrayValue arrayValue) -> void {
+					prepare(index);
+					const auto nodeType = implement.getNodeType(arrayValue);
+					if(nodeType != Implement::typeArray) {
+						metaIndexable->set(
+							container,
+							index,
+							doParse(arrayValue, nodeType, normalizePrototype(metaIndexable->getValueType(container, index)))
+						);
+						return;
+					}
+					const DepthGuard guard(depth);
+					To * group = data + index * groupSize;
+					Array groupArray = implement.getArray(arrayValue);
+					std::size_t groupCount = 0;
+					implement.iterateArray(
+						groupArray,
+						[this, groupSize, group, &groupCount](const std::size_t groupIndex, ArrayValue groupValue) -> void {
+							// The extra numbers are ignored, the missing numbers are zero, same as converting to std::array.
+							if(groupIndex >= groupSize) {
+								return;
+							}
+							groupCount = groupIndex + 1;
+							const auto groupValueType = implement.getNodeType(groupValue);
+							if(! doWriteNumber(groupValue, groupValueType, group + groupIndex)) {
+								group[groupIndex] = doParse(groupValue, groupValueType, metapp::getMetaType<To>()).template get<To>();
+							}
+						}
+					);
+					// The group may hold the numbers of the previous value in parseInto.
+					std::fill(group + groupCount, group + groupSize, To());
+				}
+			);
+		}
+		if(count < size) {
+			metaIndexable->resize(container, count);
+		}
+	}
+
+	template <typename To>
+	static To * getNumberData(const metapp::Variant & container, const metapp::MetaIndexable * metaIndexable) {
+		return static_cast<To *>(metaIndexable->get(container, 0).getAddress());
+	}
+
+	// Make `index` valid in `container` which has `size` elements. The container only grows when the size
+	// is not known before iterating, see Implement::knowsContainerSize.
+	static void growIndexable(
+			const metapp::Variant & container,
+			const metapp::MetaIndexable * metaIndexable,
+			const std::size_t index,
+			std::size_t & size
+		)
+	{
+		if(index >= size) {
+			size = index + 1;
+			metaIndexable->resize(container, size);
+		}
+	}
+
+	// Returns false if the node is not a number or boolean, then nothing is written.
+	template <typename T, typename NodeType, typename To>
+	bool doWriteNumber(T && node, const NodeType nodeType, To * address) {
+		if(nodeType == Implement::typeDouble) {
+			internal_::writeNumber<To>(address, (JsonReal)(implement.getDouble(std::forward<T>(node))));
+		}
+		else if(nodeType == Implement::typeInteger) {
+			internal_::writeNumber<To>(address, (JsonInt)(implement.getInteger(std::forward<T>(node))));
+		}
+		else if(nodeType == Implement::typeUnsignedInteger) {
+			internal_::writeNumber<To>(address, (JsonUnsignedInt)(implement.getUnsignedInteger(std::forward<T>(node))));
+		}
+		else if(nodeType == Implement::typeBoolean) {
+			internal_::writeNumber<To>(address, (JsonInt)(implement.getBoolean(std::forward<T>(node)) ? 1 : 0));
+		}
+		else {
+			return false;
+		}
+		return true;
+	}
+
+	// Like getClassParsePlan, the nested arrays usually have the same type, so the last layout is remembered.
+	const internal_::NumericArrayLayout * getNumericArrayLayout(const metapp::MetaType * arrayType) {
+		if(arrayType != cachedArrayType) {
+			cachedNumericArrayLayout = internal_::getNumericArrayLayout(arrayType);
+			cachedArrayType = arrayType;
+		}
+		return cachedNumericArrayLayout;
+	}
+
+	// `depth` includes the object being converted, so the depth of the object is `depth - 1`.
+	bool skipKey(const bool filterKeys, const JsonStringView & key) const {
+		return filterKeys && ! keyFilter->accept(key, depth - 1);
+	}
+
+	// Arrays of objects usually have the same class, so we remember the last plan to avoid the hash lookup in the cache.
+	const internal_::ClassParsePlan * getClassParsePlan(const metapp::MetaClass * metaClass) {
+		if(metaClass != cachedMetaClass) {
+			cachedClassParsePlan = internal_::getClassParsePlan(metaClass);
+			cachedMetaClass = metaClass;
+		}
+		return cachedClassParsePlan;
+	}
+
 private:
 	const ParserConfig & config;
 	Implement implement;
+	const metapp::MetaClass * cachedMetaClass;
+	const internal_::ClassParsePlan * cachedClassParsePlan;
+	const metapp::MetaType * cachedArrayType;
+	const internal_::NumericArrayLayout * cachedNumericArrayLayout;
+	internal_::EnumCacheList enumCacheList;
+	const internal_::KeyFilter * keyFilter;
+	std::size_t depth;
+};
+
+namespace internal_ {
+
+// Build a JsonDocument from the nodes of a backend. All nodes, keys and strings are allocated in the document arena.
+template <typename Implement>
+class DocumentBuilder
+{
+private:
+	using ArrayValue = typename Implement::ArrayValue;
+	using ObjectValue = typename Implement::ObjectValue;
+	using Array = typename Implement::Array;
+	using Object = typename Implement::Object;
+
+public:
+	DocumentBuilder(JsonDocument & document, const ParserConfig & config, const Implement & implement = Implement())
+		:
+			implement(implement),
+			document(document),
+			arena(document.getArena()),
+			stringPool(nullptr),
+			zeroCopy(false),
+			elementScratchList(),
+			memberScratchList(),
+			elementLevel(0),
+			memberLevel(0)
+	{
+		if(! document.getStringPool()) {
+			document.setStringPool(config.getStringPool());
+		}
+		stringPool = document.getStringPool().get();
+	}
+
+	template <typename T>
+	void build(T && node) {
+		document.clear();
+		doBuild(std::forward<T>(node), document.getMutableRoot());
+	}
+
+	// The keys and strings refer to the null terminated strings owned by `backendBuffer` instead of being copied.
+	// The document keeps `backendBuffer` alive.
+	template <typename T>
+	void buildZeroCopy(T && node, const std::shared_ptr<void> & backendBuffer) {
+		document.clear();
+		document.backendBuffer = backendBuffer;
+		zeroCopy = true;
+		doBuild(std::forward<T>(node), document.getMutableRoot());
+	}
+
+private:
+	template <typename T>
+	void doBuild(T && node, JsonNode & target)
+	{
+		switch(implement.getNodeType(node)) {
+		case Implement::typeNull:
+			target.type = JsonType::jtNull;
+			break;
+
+		case Implement::typeBoolean:
+			target.type = JsonType::jtBool;
+			target.value.b = (JsonBool)(implement.getBoolean(std::forward<T>(node)));
+			break;
+
+		case Implement::typeInteger:
+			target.type = JsonType::jtInt;
+			target.value.i = (JsonInt)(implement.getInteger(std::forward<T>(node)));
+			break;
+
+		case Implement::typeUnsignedInteger:
+			target.type = JsonType::jtUnsignedInt;
+			target.value.u = (JsonUnsignedInt)(implement.getUnsignedInteger(std::forward<T>(node)));
+			break;
+
+		case Implement::typeDouble:
+			target.type = JsonType::jtReal;
+			target.value.d = (JsonReal)(implement.getDouble(std::forward<T>(node)));
+			break;
+
+		case Implement::typeString: {
+			const JsonStringView s = implement.getStringView(std::forward<T>(node));
+			target.type = JsonType::jtString;
+			target.length = toLength(s.size());
+			target.value.s = storeString(s);
+			break;
+		}
+
+		case Implement::typeArray:
+			doBuildArray(std::forward<T>(node), target);
+			break;
+
+		case Implement::typeObject:
+			doBuildObject(std::forward<T>(node), target);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	template <typename T>
+	void doBuildArray(T && node, JsonNode & target)
+	{
+		Array array = implement.getArray(std::forward<T>(node));
+		if(! Implement::knowsContainerSize) {
+			doBuildArrayByAppending(array, target);
+			return;
+		}
+		const std::size_t size = implement.getArraySize(array);
+		JsonNode * elements = allocateNodes<JsonNode>(size);
+		target.type = JsonType::jtArray;
+		target.length = toLength(size);
+		target.value.elements = elements;
+		implement.iterateArray(
+			array,
+			[this, elements, size](const std::size_t index, ArrayValue arrayValue) -> void {
+				if(index < size) {
+					doBuild(arrayValue, elements[index]);
+				}
+			}
+		);
+	}
+
+	template <typename T>
+	void doBuildObject(T && node, JsonNode & target)
+	{
+		Object object = implement.getObject(std::forward<T>(node));
+		if(! Implement::knowsContainerSize) {
+			doBuildObjectByAppending(object, target);
+			return;
+		}
+		const std::size_t size = implement.getObjectSize(object);
+		JsonMember * members = allocateNodes<JsonMember>(size);
+		std::size_t count = 0;
+		target.type = JsonType::jtObject;
+		target.value.members = members;
+		implement.iterateObject(
+			object,
+			[this, members, size, &count](const JsonStringView & key, ObjectValue objectValue) -> void {
+				if(count < size) {
+					JsonMember & member = members[count];
+					member.key = storeString(key);
+					member.keyLength = key.size();
+					doBuild(objectValue, member.value);
+					++count;
+				}
+			}
+		);
+		target.length = toLength(count);
+	}
+
+	// The size is not known before iterating, so the elements are built in a scratch list, then copied to the arena.
+	void doBuildArrayByAppending(Array & array, JsonNode & target)
+	{
+		std::vector<JsonNode> & elements = acquireScratch(elementScratchList, elementLevel);
+		implement.iterateArray(
+			array,
+			[this, &elements](const std::size_t /*index*/, ArrayValue arrayValue) -> void {
+				elements.emplace_back();
+				doBuild(arrayValue, elements.back());
+			}
+		);
+		JsonNode * nodes = allocateNodes<JsonNode>(elements.size());
+		std::copy(elements.begin(), elements.end(), nodes);
+		target.type = JsonType::jtArray;
+		target.length = toLength(elements.size());
+		target.value.elements = nodes;
+		--elementLevel;
+	}
+
+	void doBuildObjectByAppending(Object & object, JsonNode & target)
+	{
+		std::vector<JsonMember> & members = acquireScratch(memberScratchList, memberLevel);
+		implement.iterateObject(
+			object,
+			[this, &members](const JsonStringView & key, ObjectValue objectValue) -> void {
+				members.emplace_back();
+				JsonMember & member = members.back();
+				member.key = storeString(key);
+				member.keyLength = key.size();
+				doBuild(objectValue, member.value);
+			}
+		);
+		JsonMember * nodes = allocateNodes<JsonMember>(members.size());
+		std::copy(members.begin(), members.end(), nodes);
+		target.type = JsonType::jtObject;
+		target.length = toLength(members.size());
+		target.value.members = nodes;
+		--memberLevel;
+	}
+
+	// Returns the empty scratch list of the next nesting level, the caller decreases `level` when it's done.
+	// The lists are kept in std::deque so the lists of the outer levels are not moved when a level is added,
+	// and they are reused by the containers at the same level.
+	template <typename U>
+	static std::vector<U> & acquireScratch(std::deque<std::vector<U> > & scratchList, std::size_t & level) {
+		if(level == scratchList.size()) {
+			scratchList.emplace_back();
+		}
+		std::vector<U> & scratch = scratchList[level];
+		++level;
+		scratch.clear();
+		return scratch;
+	}
+
+	template <typename U>
+	U * allocateNodes(const std::size_t count) {
+		if(count == 0) {
+			return nullptr;
+		}
+		U * result = static_cast<U *>(arena.allocate(sizeof(U) * count, alignof(U)));
+		for(std::size_t i = 0; i < count; ++i) {
+			new (result + i) U();
+		}
+		return result;
+	}
+
+	const char * storeString(const JsonStringView & s) {
+		if(zeroCopy) {
+			return s.data();
+		}
+		if(stringPool != nullptr) {
+			const char * pooled = stringPool->intern(s.data(), s.size());
+			if(pooled != nullptr) {
+				return pooled;
+			}
+		}
+		char * result = static_cast<char *>(arena.allocate(s.size() + 1, 1));
+		memcpy(result, s.data(), s.size());
+		result[s.size()] = 0;
+		return result;
+	}
+
+	static uint32_t toLength(const std::size_t length) {
+		if(length > (std::numeric_limits<uint32_t>::max)()) {
+			throw std::range_error("JSON value is too large for JsonDocument.");
+		}
+		return static_cast<uint32_t>(length);
+	}
+
+private:
+	Implement implement;
+	JsonDocument & document;
+	MonotonicArena & arena;
+	StringPool * stringPool;
+	bool zeroCopy;
+	std::deque<std::vector<JsonNode> > elementScratchList;
+	std::deque<std::vector<JsonMember> > memberScratchList;
+	std::size_t elementLevel;
+	std::size_t memberLevel;
+};
+
+// Walk the nodes in document order and pass them to ParserHandler, used by Parser::visit.
+template <typename Implement>
+class EventWalker
+{
+private:
+	using ArrayValue = typename Implement::ArrayValue;
+	using ObjectValue = typename Implement::ObjectValue;
+	using Array = typename Implement::Array;
+	using Object = typename Implement::Object;
+
+public:
+	explicit EventWalker(ParserHandler & handler, const Implement & implement = Implement())
+		: implement(implement), handler(handler)
+	{
+	}
+
+	template <typename T>
+	void walk(T && node)
+	{
+		switch(implement.getNodeType(node)) {
+		case Implement::typeNull:
+			handler.onNull();
+			break;
+
+		case Implement::typeBoolean:
+			handler.onBool(implement.getBoolean(std::forward<T>(node)));
+			break;
+
+		case Implement::typeInteger:
+			handler.onInt(implement.getInteger(std::forward<T>(node)));
+			break;
+
+		case Implement::typeUnsignedInteger:
+			handler.onUint(implement.getUnsignedInteger(std::forward<T>(node)));
+			break;
+
+		case Implement::typeDouble:
+			handler.onDouble(implement.getDouble(std::forward<T>(node)));
+			break;
+
+		case Implement::typeString:
+			handler.onString(implement.getStringView(std::forward<T>(node)));
+			break;
+
+		case Implement::typeArray: {
+			Array array = implement.getArray(std::forward<T>(node));
+			handler.onStartArray(implement.getArraySize(array));
+			implement.iterateArray(
+				array,
+				[this](const std::size_t /*index*/, ArrayValue arrayValue) -> void {
+					walk(arrayValue);
+				}
+			);
+			handler.onEndArray();
+			break;
+		}
+
+		case Implement::typeObject: {
+			Object object = implement.getObject(std::forward<T>(node));
+			handler.onStartObject(implement.getObjectSize(object));
+			implement.iterateObject(
+				object,
+				[this](const JsonStringView & key, ObjectValue objectValue) -> void {
+					handler.onKey(key);
+					walk(objectValue);
+				}
+			);
+			handler.onEndObject();
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+private:
+	Implement implement;
+	ParserHandler & handler;
+};
+
+// The Implement for GeneralParser to convert the nodes in JsonDocument.
+struct JsonNodeImplement
+{
+	using ArrayValue = const JsonNode *;
+	using ObjectValue = const JsonNode *;
+	using Array = const JsonNode *;
+	using Object = const JsonNode *;
+
+	static constexpr auto typeNull = JsonType::jtNull;
+	static constexpr auto typeBoolean = JsonType::jtBool;
+	static constexpr auto typeInteger = JsonType::jtInt;
+	static constexpr auto typeUnsignedInteger = JsonType::jtUnsignedInt;
+	static constexpr auto typeDouble = JsonType::jtReal;
+	static constexpr auto typeString = JsonType::jtString;
+	static constexpr auto typeArray = JsonType::jtArray;
+	static constexpr auto typeObject = JsonType::jtObject;
+	static constexpr bool knowsContainerSize = true;
+
+	JsonType getNodeType(const JsonNode * node) const {
+		return node->getType();
+	}
+
+	bool getBoolean(const JsonNode * node) const {
+		return node->getBool();
+	}
+
+	int64_t getInteger(const JsonNode * node) const {
+		return node->getInt();
+	}
+
+	uint64_t getUnsignedInteger(const JsonNode * node) const {
+		return node->getUnsignedInt();
+	}
+
+	double getDouble(const JsonNode * node) const {
+		return node->getReal();
+	}
+
+	JsonStringView getStringView(const JsonNode * node) const {
+		return node->getStringView();
+	}
+
+	const JsonNode * getArray(const JsonNode * node) const {
+		return node;
+	}
+
+	const JsonNode * getObject(const JsonNode * node) const {
+		return node;
+	}
+
+	std::size_t getArraySize(const JsonNode * node) const {
+		return node->getSize();
+	}
+
+	template <typename Callback>
+	void iterateArray(const JsonNode * node, const Callback & callback) const {
+		const std::size_t size = node->getSize();
+		for(std::size_t i = 0; i < size; ++i) {
+			callback(i, &(*node)[i]);
+		}
+	}
+
+	std::size_t getObjectSize(const JsonNode * node) const {
+		return node->getSize();
+	}
+
+	template <typename Callback>
+	void iterateObject(const JsonNode * node, const Callback & callback) const {
+		const std::size_t size = node->getSize();
+		for(std::size_t i = 0; i < size; ++i) {
+			const JsonMember & member = node->getMember(i);
+			callback(JsonStringView(member.key, member.keyLength), &member.value);
+		}
+	}
+
 };
 
+} // namespace internal_
+
 
 } // namespace jsonpp
 
@@ -0,0 +1,145 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef JSONPP_PARSERPOOL_H_821598293712
+#define JSONPP_PARSERPOOL_H_821598293712
+
+#include "jsonpp/parser.h"
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+struct ParserPoolSlot;
+
+} // namespace internal_
+
+// ParserPool hands out the parsers with the same config to multiple threads, the parsers are reused instead of
+// being constructed for each request. All functions are thread safe, the idle parsers are kept in a lock-free list.
+// The pool must outlive all leases.
+class ParserPool
+{
+public:
+	// Lease owns a parser from the pool, the parser is returned to the pool when the lease is destroyed.
+	class Lease
+	{
+	public:
+		Lease(Lease && other) noexcept : pool(other.pool), parser(other.parser) {
+			other.parser = nullptr;
+		}
+
+		~Lease();
+
+		Parser & operator * () const {
+			return *parser;
+		}
+
+		Parser * operator -> () const {
+			return parser;
+		}
+
+		Parser & get() const {
+			return *parser;
+		}
+
+	private:
+		Lease(ParserPool * pool, Parser * parser) : pool(pool), parser(parser) {
+		}
+
+		Lease(const Lease &) = delete;
+		Lease & operator = (const Lease &) = delete;
+		Lease & operator = (Lease &&) = delete;
+
+	private:
+		ParserPool * pool;
+		Parser * parser;
+
+		friend class ParserPool;
+	};
+
+	struct Stats
+	{
+		// The count of parsers that are leased.
+		std::size_t inUseCount;
+		// The count of parsers that are kept in the pool.
+		std::size_t idleCount;
+		// The bytes held by the idle parsers. The parsers in use are not counted, they may grow while parsing.
+		std::size_t idleMemorySize;
+		// The count of parsers constructed by the pool.
+		std::size_t createdCount;
+		// The count of times the memory of a returned parser is released because it's above the memory ceiling.
+		std::size_t trimmedCount;
+	};
+
+public:
+	// At most `maxIdleCount` parsers are kept in the pool, the extra returned parsers are destroyed.
+	// If `maxIdleCount` is 0, std::thread::hardware_concurrency() is used.
+	explicit ParserPool(const ParserConfig & config = ParserConfig(), const std::size_t maxIdleCount = 0);
+	~ParserPool();
+
+	// Returns an idle parser, or a new parser if there is no idle one.
+	Lease acquire();
+
+	std::size_t getMaxIdleCount() const {
+		return maxIdleCount;
+	}
+
+	std::size_t getMemoryCeiling() const {
+		return memoryCeiling.load(std::memory_order_relaxed);
+	}
+
+	// When a parser is returned, if it holds more than `memoryCeiling` bytes, such as after parsing an unusually large
+	// document, its memory is released. 0 means no ceiling, which is the default.
+	ParserPool & setMemoryCeiling(const std::size_t memoryCeiling_) {
+		memoryCeiling.store(memoryCeiling_, std::memory_order_relaxed);
+		return *this;
+	}
+
+	Stats getStats() const;
+
+private:
+	ParserPool(const ParserPool &) = delete;
+	ParserPool & operator = (const ParserPool &) = delete;
+
+	void release(Parser * parser);
+
+private:
+	ParserConfig config;
+	std::size_t maxIdleCount;
+	std::atomic<std::size_t> memoryCeiling;
+	std::unique_ptr<internal_::ParserPoolSlot[]> slotList;
+	// The heads of the lock-free stacks of the slots that have parser (idle) and the slots that don't (empty).
+	// The low 32 bits are the slot index + 1, 0 means the stack is empty. The high 32 bits are a tag which is changed
+	// on each update, to avoid the ABA problem.
+	std::atomic<uint64_t> idleHead;
+	std::atomic<uint64_t> emptyHead;
+	std::atomic<std::size_t> inUseCount;
+	std::atomic<std::size_t> idleCount;
+	std::atomic<std::size_t> idleMemorySize;
+	std::atomic<std::size_t> createdCount;
+	std::atomic<std::size_t> trimmedCount;
+};
+
+
+} // namespace jsonpp
+
+#endif
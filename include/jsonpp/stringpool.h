@@ -0,0 +1,108 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_STRINGPOOL_H_821598293712
+#define JSONPP_STRINGPOOL_H_821598293712
+
+#include "jsonpp/document.h"
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace jsonpp {
+
+// StringPool stores one immutable copy for each distinct string, such as object keys and enum-like values that
+// repeat in a large document. It's used by JsonDocument, the nodes refer to the pooled strings directly.
+// The pool is bounded, strings longer than maxLength, or new strings after the pool has maxCount strings, are not pooled.
+// The strings are never released until the pool is destroyed.
+// StringPool is thread safe, one pool can be shared by the parsers in ParserPool or ParallelParser via ParserConfig.
+// `intern` locks a mutex, so a pool shared by many threads that build large documents may be contended.
+class StringPool
+{
+public:
+	explicit StringPool(const std::size_t maxCount = 65536, const std::size_t maxLength = 64);
+	~StringPool();
+
+	// Returns the pooled null terminated string, or nullptr if the string can't be pooled.
+	const char * intern(const char * s, const std::size_t length);
+
+	std::size_t getMaxCount() const {
+		return maxCount;
+	}
+
+	std::size_t getMaxLength() const {
+		return maxLength;
+	}
+
+	// The number of distinct strings in the pool.
+	std::size_t getCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return count;
+	}
+
+	// The number of `intern` calls that found the string in the pool.
+	std::size_t getHitCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return hitCount;
+	}
+
+	// The number of `intern` calls that didn't find the string, including the strings that can't be pooled.
+	std::size_t getMissCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return missCount;
+	}
+
+	void resetStatistics() {
+		std::lock_guard<std::mutex> lock(mutex);
+		hitCount = 0;
+		missCount = 0;
+	}
+
+	// Bytes used by the pooled strings and the hash table.
+	std::size_t getMemorySize() const;
+
+private:
+	StringPool(const StringPool &) = delete;
+	StringPool & operator = (const StringPool &) = delete;
+
+	struct Slot
+	{
+		const char * s;
+		std::size_t length;
+		uint64_t hash;
+	};
+
+	void rehash(const std::size_t slotCount);
+
+private:
+	std::size_t maxCount;
+	std::size_t maxLength;
+	std::size_t count;
+	std::size_t hitCount;
+	std::size_t missCount;
+	// Open addressing table, a slot with s == nullptr is empty.
+	std::vector<Slot> slotList;
+	std::size_t slotMask;
+	internal_::MonotonicArena arena;
+	mutable std::mutex mutex;
+};
+
+
+} // namespace jsonpp
+
+#endif
@@ -0,0 +1,126 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JSONPP_STRINGVIEW_H_821598293712
+#define JSONPP_STRINGVIEW_H_821598293712
+
+#include <string>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+#define JSONPP_HAS_STD_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace jsonpp {
+
+// A non-owning reference to a string, the same as std::string_view which is not available in C++11.
+// If the compiler supports C++17, JsonStringView converts to std::string_view implicitly.
+class JsonStringView
+{
+public:
+	using const_iterator = const char *;
+
+public:
+	JsonStringView()
+		: s(nullptr), length(0)
+	{
+	}
+
+	JsonStringView(const char * s, const std::size_t length)
+		: s(s), length(length)
+	{
+	}
+
+	JsonStringView(const char * s)
+		: s(s), length(strlen(s))
+	{
+	}
+
+	JsonStringView(const std::string & s)
+		: s(s.data()), length(s.size())
+	{
+	}
+
+	const char * data() const {
+		return s;
+	}
+
+	std::size_t size() const {
+		return length;
+	}
+
+	bool empty() const {
+		return length == 0;
+	}
+
+	const_iterator begin() const {
+		return s;
+	}
+
+	const_iterator end() const {
+		return s + length;
+	}
+
+	char operator[] (const std::size_t index) const {
+		return s[index];
+	}
+
+	std::string toString() const {
+		return std::string(s, length);
+	}
+
+	int compare(const JsonStringView & other) const {
+		const std::size_t commonLength = (std::min)(length, other.length);
+		const int result = (commonLength == 0 ? 0 : memcmp(s, other.s, commonLength));
+		if(result != 0) {
+			return result;
+		}
+		return length < other.length ? -1 : (length > other.length ? 1 : 0);
+	}
+
+#ifdef JSONPP_HAS_STD_STRING_VIEW
+	operator std::string_view() const {
+		return std::string_view(s, length);
+	}
+#endif
+
+private:
+	const char * s;
+	std::size_t length;
+};
+
+inline bool operator == (const JsonStringView & a, const JsonStringView & b)
+{
+	return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+inline bool operator != (const JsonStringView & a, const JsonStringView & b)
+{
+	return ! (a == b);
+}
+
+inline bool operator < (const JsonStringView & a, const JsonStringView & b)
+{
+	return a.compare(b) < 0;
+}
+
+
+} // namespace jsonpp
+
+#endif
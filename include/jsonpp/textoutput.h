@@ -234,6 +234,11 @@ struct TextOutput
 		writer('"');
 	}
 
+	// Write the string which is already quoted and escaped, such as the cached enum names.
+	void writeEncodedString(const char * const s, const std::size_t length) const {
+		writer(s, length);
+	}
+
 	void beginArray() const {
 		writer('[');
 		writeLineBreak();
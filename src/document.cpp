@@ -0,0 +1,238 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/document.h"
+
+#include <cstring>
+#include <utility>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+MonotonicArena::MonotonicArena(const std::size_t initialBlockSize)
+	:
+		blockList(),
+		blockSizeList(),
+		current(nullptr),
+		end(nullptr),
+		initialBlockSize(initialBlockSize)
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+}
+
+MonotonicArena::MonotonicArena(MonotonicArena && other)
+	:
+		blockList(std::move(other.blockList)),
+		blockSizeList(std::move(other.blockSizeList)),
+		current(other.current),
+		end(other.end),
+		initialBlockSize(other.initialBlockSize)
+{
+	other.blockList.clear();
+	other.blockSizeList.clear();
+	other.current = nullptr;
+	other.end = nullptr;
+}
+
+MonotonicArena & MonotonicArena::operator = (MonotonicArena && other)
+{
+	if(this != &other) {
+		blockList = std::move(other.blockList);
+		blockSizeList = std::move(other.blockSizeList);
+		current = other.current;
+		end = other.end;
+		initialBlockSize = other.initialBlockSize;
+		other.blockList.clear();
+		other.blockSizeList.clear();
+		other.current = nullptr;
+		other.end = nullptr;
+	}
+	return *this;
+}
+
+void * MonotonicArena::allocate(const std::size_t size, const std::size_t alignment)
+{
+	std::size_t padding = (alignment - (reinterpret_cast<std::uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+	if(current == nullptr || size + padding > static_cast<std::size_t>(end - current)) {
+		addBlock(size + alignment);
+		padding = (alignment - (reinterpret_cast<std::uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+	}
+	char * result = current + padding;
+	current = result + size;
+	return result;
+}
+
+void MonotonicArena::reset()
+{
+	if(blockList.empty()) {
+		return;
+	}
+	// The last block is always the largest one because the block size grows geometrically.
+	std::unique_ptr<char[]> block = std::move(blockList.back());
+	const std::size_t blockSize = blockSizeList.back();
+	blockList.clear();
+	blockSizeList.clear();
+	blockList.push_back(std::move(block));
+	blockSizeList.push_back(blockSize);
+	current = blockList.back().get();
+	end = current + blockSize;
+}
+
+std::size_t MonotonicArena::getCapacity() const
+{
+	std::size_t capacity = 0;
+	for(const auto size : blockSizeList) {
+		capacity += size;
+	}
+	return capacity;
+}
+
+void MonotonicArena::addBlock(const std::size_t minSize)
+{
+	std::size_t blockSize = blockSizeList.empty() ? initialBlockSize : blockSizeList.back() * 2;
+	if(blockSize < minSize) {
+		blockSize = minSize;
+	}
+	blockList.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+	blockSizeList.push_back(blockSize);
+	current = blockList.back().get();
+	end = current + blockSize;
+}
+
+} // namespace internal_
+
+JsonNode::JsonNode()
+	: type(JsonType::jtNone), length(0), value()
+{
+	value.u = 0;
+}
+
+std::size_t JsonNode::getSize() const
+{
+	if(type == JsonType::jtArray || type == JsonType::jtObject) {
+		return length;
+	}
+	return 0;
+}
+
+const JsonNode * JsonNode::find(const char * key, const std::size_t keyLength) const
+{
+	if(type != JsonType::jtObject) {
+		return nullptr;
+	}
+	for(std::size_t i = 0; i < length; ++i) {
+		const JsonMember & member = value.members[i];
+		if(member.keyLength == keyLength && memcmp(member.key, key, keyLength) == 0) {
+			return &member.value;
+		}
+	}
+	return nullptr;
+}
+
+metapp::Variant JsonNode::toVariant() const
+{
+	switch(type) {
+	case JsonType::jtNull:
+		return metapp::Variant(nullptr);
+
+	case JsonType::jtBool:
+		return value.b;
+
+	case JsonType::jtInt:
+		return value.i;
+
+	case JsonType::jtUnsignedInt:
+		return value.u;
+
+	case JsonType::jtReal:
+		return value.d;
+
+	case JsonType::jtString:
+		return JsonString(value.s, length);
+
+	case JsonType::jtArray: {
+		JsonArray array(length);
+		for(std::size_t i = 0; i < length; ++i) {
+			array[i] = value.elements[i].toVariant();
+		}
+		return array;
+	}
+
+	case JsonType::jtObject: {
+		JsonObject object;
+		for(std::size_t i = 0; i < length; ++i) {
+			const JsonMember & member = value.members[i];
+			object.insert(std::make_pair(JsonString(member.key, member.keyLength), member.value.toVariant()));
+		}
+		return object;
+	}
+
+	default:
+		break;
+	}
+	return metapp::Variant();
+}
+
+JsonDocument::JsonDocument()
+	: arena(), root(), stringPool(), backendBuffer()
+{
+}
+
+JsonDocument::~JsonDocument()
+{
+}
+
+JsonDocument::JsonDocument(JsonDocument && other)
+	:
+		arena(std::move(other.arena)),
+		root(other.root),
+		stringPool(std::move(other.stringPool)),
+		backendBuffer(std::move(other.backendBuffer))
+{
+	other.root = JsonNode();
+}
+
+JsonDocument & JsonDocument::operator = (JsonDocument && other)
+{
+	if(this != &other) {
+		arena = std::move(other.arena);
+		root = other.root;
+		stringPool = std::move(other.stringPool);
+		backendBuffer = std::move(other.backendBuffer);
+		other.root = JsonNode();
+	}
+	return *this;
+}
+
+void JsonDocument::clear()
+{
+	root = JsonNode();
+	arena.reset();
+	backendBuffer.reset();
+}
+
+std::size_t JsonDocument::getMemorySize() const
+{
+	return arena.getCapacity();
+}
+
+
+} // namespace jsonpp
+
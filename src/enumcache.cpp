@@ -0,0 +1,126 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "jsonpp/enumcache.h"
+#include "jsonpp/hashobject.h"
+#include "jsonpp/textoutput.h"
+#include "jsonpp/implement/typecache_i.h"
+
+#include "metapp/allmetatypes.h"
+
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+EnumCache::EnumCache(const metapp::MetaEnum * metaEnum)
+	: itemList(), nameSlotList(), nameSlotMask(0), denseIndexList(), minValue(0), valueIndexMap()
+{
+	for(const auto & metaItem : metaEnum->getValueView()) {
+		StringWriter writer;
+		TextOutput<StringWriter>(writer).writeString(metaItem.getName().c_str(), metaItem.getName().size());
+		itemList.push_back({
+			metaItem.getName(),
+			writer.getString(),
+			metaItem.asEnumValue().cast<long long>().get<long long>()
+		});
+	}
+
+	if(itemList.empty()) {
+		return;
+	}
+
+	// Keep the load factor below 0.5
+	std::size_t slotCount = 8;
+	while(slotCount < itemList.size() * 2) {
+		slotCount <<= 1;
+	}
+	nameSlotList.resize(slotCount);
+	nameSlotMask = slotCount - 1;
+	for(std::size_t i = 0; i < itemList.size(); ++i) {
+		const std::string & name = itemList[i].name;
+		if(findByName(name.data(), name.size()) != nullptr) {
+			// Same as MetaEnum::getByName, the first item wins.
+			continue;
+		}
+		std::size_t slot = static_cast<std::size_t>(hashKey(name.data(), name.size())) & nameSlotMask;
+		while(nameSlotList[slot] != 0) {
+			slot = (slot + 1) & nameSlotMask;
+		}
+		nameSlotList[slot] = static_cast<uint32_t>(i + 1);
+	}
+
+	long long maxValue = itemList[0].value;
+	minValue = itemList[0].value;
+	for(const auto & item : itemList) {
+		minValue = (std::min)(minValue, item.value);
+		maxValue = (std::max)(maxValue, item.value);
+	}
+	// Enum values are usually consecutive, then the dense table is both smaller and faster than the hash table.
+	const unsigned long long range = static_cast<unsigned long long>(maxValue) - static_cast<unsigned long long>(minValue);
+	if(range < itemList.size() * 2 + 64) {
+		denseIndexList.resize(static_cast<std::size_t>(range) + 1);
+		for(std::size_t i = 0; i < itemList.size(); ++i) {
+			uint32_t & index = denseIndexList[static_cast<std::size_t>(itemList[i].value - minValue)];
+			if(index == 0) {
+				index = static_cast<uint32_t>(i + 1);
+			}
+		}
+	}
+	else {
+		for(std::size_t i = 0; i < itemList.size(); ++i) {
+			valueIndexMap.insert(std::make_pair(itemList[i].value, i));
+		}
+	}
+}
+
+const EnumCache::Item * EnumCache::findByName(const char * name, const std::size_t nameLength) const
+{
+	if(nameSlotList.empty()) {
+		return nullptr;
+	}
+	std::size_t slot = static_cast<std::size_t>(hashKey(name, nameLength)) & nameSlotMask;
+	for(;;) {
+		const uint32_t itemIndex = nameSlotList[slot];
+		if(itemIndex == 0) {
+			return nullptr;
+		}
+		const Item & item = itemList[itemIndex - 1];
+		if(item.name.size() == nameLength && memcmp(item.name.data(), name, nameLength) == 0) {
+			return &item;
+		}
+		slot = (slot + 1) & nameSlotMask;
+	}
+}
+
+const EnumCache * getEnumCache(const metapp::MetaEnum * metaEnum)
+{
+	using Cache = TypeCache<const metapp::MetaEnum *, EnumCache>;
+	static Cache cache;
+	thread_local Cache::ThreadMap threadMap;
+
+	return cache.get(threadMap, metaEnum, [](const metapp::MetaEnum * metaEnum) {
+		return std::unique_ptr<EnumCache>(new EnumCache(metaEnum));
+	});
+}
+
+} // namespace internal_
+
+} // namespace jsonpp
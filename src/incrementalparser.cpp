@@ -0,0 +1,829 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/incrementalparser.h"
+#include "jsonpp/parserbackend.h"
+#include "jsonpp/stringpool.h"
+
+#if defined(METAPP_COMPILER_VC)
+#pragma warning(push)
+#pragma warning(disable: 4245 4100 4459)
+#endif
+#if defined(METAPP_COMPILER_GCC)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+
+// Only for the exact, locale independent string to double conversion.
+#include "thirdparty/simdjson/simdjson.h"
+
+#if defined(METAPP_COMPILER_GCC)
+#pragma GCC diagnostic pop
+#endif
+#if defined(METAPP_COMPILER_VC)
+#pragma warning(pop)
+#endif
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// The same as the default max depth in simdjson and backend native. finish() converts the document recursively,
+// so a deeper document, such as a stream of '[' from a socket peer, would overflow the stack.
+constexpr std::size_t incrementalMaxDepth = 1024;
+
+// A resumable JSON tokenizer. The input can be split at any byte, the partial token is kept in `token`.
+// Finished values are pushed to stacks, when an array or object is closed, its elements are moved to the document arena.
+class IncrementalTokenizer
+{
+private:
+	enum class State
+	{
+		value,
+		key,
+		colon,
+		commaOrClose,
+		string,
+		number,
+		literal,
+		commentStart,
+		lineComment,
+		blockComment,
+		blockCommentEnd,
+		end,
+		error
+	};
+
+	struct Frame
+	{
+		bool isObject;
+		// The size of nodeStack or memberStack when the array or object is opened.
+		std::size_t start;
+		// The key of the member being parsed in the object.
+		const char * key;
+		std::size_t keyLength;
+	};
+
+public:
+	explicit IncrementalTokenizer(const ParserConfig & config);
+
+	void reset();
+
+	bool feed(const char * data, const std::size_t length);
+	bool finish();
+
+	bool isComplete() const {
+		return state == State::end;
+	}
+
+	const JsonNode * getRoot() const {
+		return &document.getRoot();
+	}
+
+	const std::string & getError() const {
+		return errorMessage;
+	}
+
+private:
+	bool doFeed(const char * data, const std::size_t length);
+	bool feedStructural(const char c);
+	bool beginValue(const char c);
+	bool closeContainer(const bool isObject);
+	bool finishString();
+	bool finishNumber();
+	bool finishLiteral();
+	bool finishValue(const JsonNode & node);
+	bool unescapeToken();
+	const char * storeString(const char * s, const std::size_t length);
+	bool fail(const std::string & message);
+	bool failAt(const std::size_t position);
+
+	static bool isNumberChar(const char c) {
+		return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+
+	static bool isLiteralChar(const char c) {
+		return c >= 'a' && c <= 'z';
+	}
+
+private:
+	bool comment;
+	std::shared_ptr<StringPool> stringPool;
+	JsonDocument document;
+	std::vector<Frame> frameStack;
+	std::vector<JsonNode> nodeStack;
+	std::vector<JsonMember> memberStack;
+	State state;
+	// The state to return to after a comment.
+	State stateBeforeComment;
+	// Whether ']' or '}' is allowed in State::value or State::key, i.e, right after '[' or '{'.
+	bool allowClose;
+	bool stringIsKey;
+	bool escaped;
+	std::string token;
+	std::string unescaped;
+	// The count of bytes fed, used in error messages.
+	std::size_t offset;
+	std::string errorMessage;
+};
+
+IncrementalTokenizer::IncrementalTokenizer(const ParserConfig & config)
+	:
+		comment(config.allowComment()),
+		stringPool(config.getStringPool()),
+		document(),
+		frameStack(),
+		nodeStack(),
+		memberStack(),
+		state(State::value),
+		stateBeforeComment(State::value),
+		allowClose(false),
+		stringIsKey(false),
+		escaped(false),
+		token(),
+		unescaped(),
+		offset(0),
+		errorMessage()
+{
+	document.setStringPool(stringPool);
+}
+
+void IncrementalTokenizer::reset()
+{
+	document.clear();
+	frameStack.clear();
+	nodeStack.clear();
+	memberStack.clear();
+	state = State::value;
+	stateBeforeComment = State::value;
+	allowClose = false;
+	stringIsKey = false;
+	escaped = false;
+	token.clear();
+	offset = 0;
+	errorMessage.clear();
+}
+
+bool IncrementalTokenizer::feed(const char * data, const std::size_t length)
+{
+	if(state == State::error) {
+		return false;
+	}
+	try {
+		return doFeed(data, length);
+	}
+	catch(const std::exception & e) {
+		return fail(e.what());
+	}
+}
+
+bool IncrementalTokenizer::doFeed(const char * data, const std::size_t length)
+{
+	const char * p = data;
+	const char * const end = data + length;
+	while(p < end) {
+		switch(state) {
+		case State::string: {
+			const char * begin = p;
+			while(p < end) {
+				const char c = *p;
+				if(escaped) {
+					escaped = false;
+				}
+				else if(c == '\\') {
+					escaped = true;
+				}
+				else if(c == '"') {
+					break;
+				}
+				else if(static_cast<unsigned char>(c) < 0x20) {
+					fail("Control character in string");
+					return failAt(offset + (p - data));
+				}
+				++p;
+			}
+			token.append(begin, p);
+			if(p < end) {
+				++p;
+				if(! finishString()) {
+					return failAt(offset + (p - data));
+				}
+			}
+			break;
+		}
+
+		case State::number:
+		case State::literal: {
+			const bool isNumber = (state == State::number);
+			const char * begin = p;
+			while(p < end && (isNumber ? isNumberChar(*p) : isLiteralChar(*p))) {
+				++p;
+			}
+			token.append(begin, p);
+			// The delimiter is not consumed, it's processed as a structural character.
+			if(p < end && ! (isNumber ? finishNumber() : finishLiteral())) {
+				return failAt(offset + (p - data));
+			}
+			break;
+		}
+
+		case State::lineComment: {
+			const void * newLine = memchr(p, '\n', end - p);
+			if(newLine == nullptr) {
+				p = end;
+			}
+			else {
+				p = static_cast<const char *>(newLine) + 1;
+				state = stateBeforeComment;
+			}
+			break;
+		}
+
+		case State::blockComment: {
+			const void * star = memchr(p, '*', end - p);
+			if(star == nullptr) {
+				p = end;
+			}
+			else {
+				p = static_cast<const char *>(star) + 1;
+				state = State::blockCommentEnd;
+			}
+			break;
+		}
+
+		default:
+			if(! feedStructural(*p)) {
+				return failAt(offset + (p - data));
+			}
+			++p;
+			break;
+		}
+	}
+	offset += length;
+	return true;
+}
+
+bool IncrementalTokenizer::feedStructural(const char c)
+{
+	if(state == State::commentStart) {
+		if(c == '/') {
+			state = State::lineComment;
+		}
+		else if(c == '*') {
+			state = State::blockComment;
+		}
+		else {
+			return fail("Invalid comment");
+		}
+		return true;
+	}
+	if(state == State::blockCommentEnd) {
+		if(c == '/') {
+			state = stateBeforeComment;
+		}
+		else if(c != '*') {
+			state = State::blockComment;
+		}
+		return true;
+	}
+
+	if(c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+		return true;
+	}
+	if(c == '/' && comment) {
+		stateBeforeComment = state;
+		state = State::commentStart;
+		return true;
+	}
+
+	switch(state) {
+	case State::value:
+		if(allowClose && c == ']') {
+			return closeContainer(false);
+		}
+		return beginValue(c);
+
+	case State::key:
+		if(c == '"') {
+			state = State::string;
+			stringIsKey = true;
+			token.clear();
+			return true;
+		}
+		if(allowClose && c == '}') {
+			return closeContainer(true);
+		}
+		return fail("Expect object key");
+
+	case State::colon:
+		if(c == ':') {
+			state = State::value;
+			allowClose = false;
+			return true;
+		}
+		return fail("Expect ':' after object key");
+
+	case State::commaOrClose: {
+		const bool isObject = frameStack.back().isObject;
+		if(c == ',') {
+			state = (isObject ? State::key : State::value);
+			allowClose = false;
+			return true;
+		}
+		if(c == (isObject ? '}' : ']')) {
+			return closeContainer(isObject);
+		}
+		return fail(isObject ? "Expect ',' or '}' in object" : "Expect ',' or ']' in array");
+	}
+
+	case State::end:
+		return fail("Unexpected character after the JSON document");
+
+	default:
+		break;
+	}
+	return fail("Invalid JSON document");
+}
+
+bool IncrementalTokenizer::beginValue(const char c)
+{
+	if((c == '[' || c == '{') && frameStack.size() >= incrementalMaxDepth) {
+		return fail("The document is too deep");
+	}
+	switch(c) {
+	case '[':
+		frameStack.push_back({ false, nodeStack.size(), nullptr, 0 });
+		state = State::value;
+		allowClose = true;
+		return true;
+
+	case '{':
+		frameStack.push_back({ true, memberStack.size(), nullptr, 0 });
+		state = State::key;
+		allowClose = true;
+		return true;
+
+	case '"':
+		state = State::string;
+		stringIsKey = false;
+		token.clear();
+		return true;
+
+	default:
+		break;
+	}
+	token.clear();
+	token.push_back(c);
+	if(c == '-' || (c >= '0' && c <= '9')) {
+		state = State::number;
+		return true;
+	}
+	if(isLiteralChar(c)) {
+		state = State::literal;
+		return true;
+	}
+	return fail(std::string("Unexpected character '") + c + "'");
+}
+
+bool IncrementalTokenizer::closeContainer(const bool isObject)
+{
+	const Frame frame = frameStack.back();
+	frameStack.pop_back();
+	if((isObject ? memberStack.size() : nodeStack.size()) - frame.start > (std::numeric_limits<uint32_t>::max)()) {
+		return fail("JSON value is too large");
+	}
+	JsonNode node;
+	if(isObject) {
+		const std::size_t count = memberStack.size() - frame.start;
+		JsonMember * members = nullptr;
+		if(count > 0) {
+			members = static_cast<JsonMember *>(document.getArena().allocate(sizeof(JsonMember) * count, alignof(JsonMember)));
+			std::uninitialized_copy(memberStack.begin() + frame.start, memberStack.end(), members);
+			memberStack.resize(frame.start);
+		}
+		node.type = JsonType::jtObject;
+		node.length = static_cast<uint32_t>(count);
+		node.value.members = members;
+	}
+	else {
+		const std::size_t count = nodeStack.size() - frame.start;
+		JsonNode * elements = nullptr;
+		if(count > 0) {
+			elements = static_cast<JsonNode *>(document.getArena().allocate(sizeof(JsonNode) * count, alignof(JsonNode)));
+			std::uninitialized_copy(nodeStack.begin() + frame.start, nodeStack.end(), elements);
+			nodeStack.resize(frame.start);
+		}
+		node.type = JsonType::jtArray;
+		node.length = static_cast<uint32_t>(count);
+		node.value.elements = elements;
+	}
+	return finishValue(node);
+}
+
+bool IncrementalTokenizer::finishString()
+{
+	if(! unescapeToken()) {
+		return false;
+	}
+	if(stringIsKey) {
+		Frame & frame = frameStack.back();
+		frame.key = storeString(unescaped.data(), unescaped.size());
+		frame.keyLength = unescaped.size();
+		state = State::colon;
+		return true;
+	}
+	if(unescaped.size() > (std::numeric_limits<uint32_t>::max)()) {
+		return fail("JSON value is too large");
+	}
+	JsonNode node;
+	node.type = JsonType::jtString;
+	node.length = static_cast<uint32_t>(unescaped.size());
+	node.value.s = storeString(unescaped.data(), unescaped.size());
+	return finishValue(node);
+}
+
+bool IncrementalTokenizer::finishNumber()
+{
+	// Validate against the JSON number grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	const char * p = token.c_str();
+	const bool negative = (*p == '-');
+	if(negative) {
+		++p;
+	}
+	const char * digits = p;
+	while(*p >= '0' && *p <= '9') {
+		++p;
+	}
+	const std::size_t digitCount = p - digits;
+	bool isInteger = true;
+	bool valid = (digitCount > 0 && (digits[0] != '0' || digitCount == 1));
+	if(valid && *p == '.') {
+		isInteger = false;
+		++p;
+		const char * fraction = p;
+		while(*p >= '0' && *p <= '9') {
+			++p;
+		}
+		valid = (p > fraction);
+	}
+	if(valid && (*p == 'e' || *p == 'E')) {
+		isInteger = false;
+		++p;
+		if(*p == '+' || *p == '-') {
+			++p;
+		}
+		const char * exponent = p;
+		while(*p >= '0' && *p <= '9') {
+			++p;
+		}
+		valid = (p > exponent);
+	}
+	if(! valid || *p != 0) {
+		return fail("Invalid number " + token);
+	}
+
+	JsonNode node;
+	if(isInteger) {
+		uint64_t n = 0;
+		bool overflow = false;
+		for(std::size_t i = 0; i < digitCount; ++i) {
+			const uint64_t digit = static_cast<uint64_t>(digits[i] - '0');
+			if(n > ((std::numeric_limits<uint64_t>::max)() - digit) / 10) {
+				overflow = true;
+				break;
+			}
+			n = n * 10 + digit;
+		}
+		const uint64_t maxInt = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
+		if(! overflow) {
+			if(negative && n <= maxInt + 1) {
+				node.type = JsonType::jtInt;
+				node.value.i = (n == maxInt + 1 ? (std::numeric_limits<int64_t>::min)() : -static_cast<int64_t>(n));
+				return finishValue(node);
+			}
+			if(! negative) {
+				if(n <= maxInt) {
+					node.type = JsonType::jtInt;
+					node.value.i = static_cast<int64_t>(n);
+				}
+				else {
+					node.type = JsonType::jtUnsignedInt;
+					node.value.u = n;
+				}
+				return finishValue(node);
+			}
+		}
+	}
+	node.type = JsonType::jtReal;
+	// strtod depends on the decimal separator of the C locale, from_chars doesn't.
+	node.value.d = simdjson::internal::from_chars(token.data(), token.data() + token.size());
+	if(std::isinf(node.value.d)) {
+		return fail("Number out of range " + token);
+	}
+	return finishValue(node);
+}
+
+bool IncrementalTokenizer::finishLiteral()
+{
+	JsonNode node;
+	if(token == "null") {
+		node.type = JsonType::jtNull;
+	}
+	else if(token == "true") {
+		node.type = JsonType::jtBool;
+		node.value.b = true;
+	}
+	else if(token == "false") {
+		node.type = JsonType::jtBool;
+		node.value.b = false;
+	}
+	else {
+		return fail("Invalid literal " + token);
+	}
+	return finishValue(node);
+}
+
+bool IncrementalTokenizer::finishValue(const JsonNode & node)
+{
+	if(frameStack.empty()) {
+		document.getMutableRoot() = node;
+		state = State::end;
+	}
+	else {
+		const Frame & frame = frameStack.back();
+		if(frame.isObject) {
+			memberStack.push_back({ frame.key, frame.keyLength, node });
+		}
+		else {
+			nodeStack.push_back(node);
+		}
+		state = State::commaOrClose;
+	}
+	return true;
+}
+
+namespace {
+
+int hexToInt(const char c)
+{
+	if(c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if(c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if(c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+bool readHex4(const char * p, const char * end, uint32_t & result)
+{
+	if(end - p < 4) {
+		return false;
+	}
+	result = 0;
+	for(int i = 0; i < 4; ++i) {
+		const int n = hexToInt(p[i]);
+		if(n < 0) {
+			return false;
+		}
+		result = (result << 4) | static_cast<uint32_t>(n);
+	}
+	return true;
+}
+
+void appendUtf8(std::string & s, const uint32_t codePoint)
+{
+	if(codePoint < 0x80) {
+		s.push_back(static_cast<char>(codePoint));
+	}
+	else if(codePoint < 0x800) {
+		s.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	}
+	else if(codePoint < 0x10000) {
+		s.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	}
+	else {
+		s.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+		s.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+		s.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+	}
+}
+
+} // namespace
+
+bool IncrementalTokenizer::unescapeToken()
+{
+	unescaped.clear();
+	const char * p = token.data();
+	const char * const end = p + token.size();
+	while(p < end) {
+		const char * backslash = static_cast<const char *>(memchr(p, '\\', end - p));
+		if(backslash == nullptr) {
+			unescaped.append(p, end);
+			break;
+		}
+		unescaped.append(p, backslash);
+		p = backslash + 1;
+		// The tokenizer guarantees a character follows the backslash.
+		const char c = *p++;
+		switch(c) {
+		case '"': unescaped.push_back('"'); break;
+		case '\\': unescaped.push_back('\\'); break;
+		case '/': unescaped.push_back('/'); break;
+		case 'b': unescaped.push_back('\b'); break;
+		case 'f': unescaped.push_back('\f'); break;
+		case 'n': unescaped.push_back('\n'); break;
+		case 'r': unescaped.push_back('\r'); break;
+		case 't': unescaped.push_back('\t'); break;
+
+		case 'u': {
+			uint32_t codePoint;
+			if(! readHex4(p, end, codePoint)) {
+				return fail("Invalid unicode escape in string");
+			}
+			p += 4;
+			if(codePoint >= 0xd800 && codePoint <= 0xdbff) {
+				uint32_t low;
+				if(end - p < 2 || p[0] != '\\' || p[1] != 'u' || ! readHex4(p + 2, end, low) || low < 0xdc00 || low > 0xdfff) {
+					return fail("Invalid unicode surrogate pair in string");
+				}
+				p += 6;
+				codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+			}
+			else if(codePoint >= 0xdc00 && codePoint <= 0xdfff) {
+				return fail("Invalid unicode surrogate pair in string");
+			}
+			appendUtf8(unescaped, codePoint);
+			break;
+		}
+
+		default:
+			return fail(std::string("Invalid escape character '") + c + "' in string");
+		}
+	}
+	return true;
+}
+
+const char * IncrementalTokenizer::storeString(const char * s, const std::size_t length)
+{
+	if(stringPool) {
+		const char * pooled = stringPool->intern(s, length);
+		if(pooled != nullptr) {
+			return pooled;
+		}
+	}
+	char * result = static_cast<char *>(document.getArena().allocate(length + 1, 1));
+	memcpy(result, s, length);
+	result[length] = 0;
+	return result;
+}
+
+bool IncrementalTokenizer::finish()
+{
+	if(state == State::error) {
+		return false;
+	}
+	// A number or literal at the root level is terminated by the end of the document.
+	if(frameStack.empty()) {
+		if(state == State::number) {
+			finishNumber();
+		}
+		else if(state == State::literal) {
+			finishLiteral();
+		}
+	}
+	if(state == State::lineComment && stateBeforeComment == State::end) {
+		state = State::end;
+	}
+	if(state == State::error) {
+		return failAt(offset);
+	}
+	if(state != State::end) {
+		fail("Unexpected end of JSON document");
+		return failAt(offset);
+	}
+	return true;
+}
+
+bool IncrementalTokenizer::fail(const std::string & message)
+{
+	errorMessage = message;
+	state = State::error;
+	return false;
+}
+
+bool IncrementalTokenizer::failAt(const std::size_t position)
+{
+	errorMessage += " at offset " + std::to_string(position);
+	return false;
+}
+
+} // namespace internal_
+
+IncrementalParser::IncrementalParser()
+	: IncrementalParser(ParserConfig())
+{
+}
+
+IncrementalParser::IncrementalParser(const ParserConfig & config)
+	:
+		config(config),
+		tokenizer(new internal_::IncrementalTokenizer(config)),
+		errorMessage(),
+		finished(false)
+{
+}
+
+IncrementalParser::~IncrementalParser()
+{
+}
+
+bool IncrementalParser::hasError() const
+{
+	return ! errorMessage.empty();
+}
+
+const std::string & IncrementalParser::getError() const
+{
+	return errorMessage;
+}
+
+bool IncrementalParser::feed(const char * data, const std::size_t length)
+{
+	if(finished) {
+		reset();
+	}
+	if(! tokenizer->feed(data, length)) {
+		errorMessage = tokenizer->getError();
+		return false;
+	}
+	return true;
+}
+
+bool IncrementalParser::feed(const std::string & data)
+{
+	return feed(data.data(), data.size());
+}
+
+bool IncrementalParser::isComplete() const
+{
+	return tokenizer->isComplete();
+}
+
+metapp::Variant IncrementalParser::finish(const metapp::MetaType * prototype)
+{
+	finished = true;
+	if(! tokenizer->finish()) {
+		errorMessage = tokenizer->getError();
+		return metapp::Variant();
+	}
+	try {
+		return internal_::GeneralParser<internal_::JsonNodeImplement>(config, internal_::JsonNodeImplement())
+			.parse(tokenizer->getRoot(), prototype);
+	}
+	catch(const metapp::MetaException & e) {
+		errorMessage = e.what();
+	}
+	catch(const std::exception & e) {
+		errorMessage = e.what();
+	}
+	return metapp::Variant();
+}
+
+void IncrementalParser::reset()
+{
+	tokenizer->reset();
+	errorMessage.clear();
+	finished = false;
+}
+
+
+} // namespace jsonpp
@@ -0,0 +1,90 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/keyfilter.h"
+
+#include <algorithm>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+namespace {
+
+bool lessKey(const JsonStringView & a, const JsonStringView & b)
+{
+	return a.compare(b) < 0;
+}
+
+void addKeys(std::vector<std::string> & keyList, const std::vector<std::string> & keys)
+{
+	keyList.insert(keyList.end(), keys.begin(), keys.end());
+	std::sort(keyList.begin(), keyList.end());
+	keyList.erase(std::unique(keyList.begin(), keyList.end()), keyList.end());
+}
+
+bool hasKey(const std::vector<std::string> & keyList, const JsonStringView & key)
+{
+	return std::binary_search(keyList.begin(), keyList.end(), key, &lessKey);
+}
+
+} // namespace
+
+constexpr int KeyFilter::anyDepth;
+
+KeyFilter::KeyFilter()
+	: anyDepthRule(), depthRuleList()
+{
+}
+
+void KeyFilter::include(const std::vector<std::string> & keys, const int depth)
+{
+	addKeys(getRule(depth).includeList, keys);
+}
+
+void KeyFilter::exclude(const std::vector<std::string> & keys, const int depth)
+{
+	addKeys(getRule(depth).excludeList, keys);
+}
+
+bool KeyFilter::accept(const JsonStringView & key, const std::size_t depth) const
+{
+	const Rule * depthRule = (depth < depthRuleList.size() ? &depthRuleList[depth] : nullptr);
+	if(hasKey(anyDepthRule.excludeList, key) || (depthRule != nullptr && hasKey(depthRule->excludeList, key))) {
+		return false;
+	}
+	// If there is any include key for the depth, only the included keys are accepted.
+	const bool hasInclude = ! anyDepthRule.includeList.empty() || (depthRule != nullptr && ! depthRule->includeList.empty());
+	if(! hasInclude) {
+		return true;
+	}
+	return hasKey(anyDepthRule.includeList, key) || (depthRule != nullptr && hasKey(depthRule->includeList, key));
+}
+
+KeyFilter::Rule & KeyFilter::getRule(const int depth)
+{
+	if(depth < 0) {
+		return anyDepthRule;
+	}
+	if(static_cast<std::size_t>(depth) >= depthRuleList.size()) {
+		depthRuleList.resize(depth + 1);
+	}
+	return depthRuleList[depth];
+}
+
+} // namespace internal_
+
+} // namespace jsonpp
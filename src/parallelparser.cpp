@@ -0,0 +1,577 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/parallelparser.h"
+#include "metapp/interfaces/metaclass.h"
+#include "metapp/allmetatypes.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+// The persistent worker threads of ParallelParser. Starting and joining the threads in each call costs tens of
+// microseconds, which is more than parsing a small batch.
+// The threads are started when a job needs more workers than started, and they wait for the next job between the calls.
+class WorkerPool
+{
+public:
+	using Job = std::function<void (const std::size_t workerIndex)>;
+
+	WorkerPool()
+		:
+			threadList(),
+			mutex(),
+			startCondition(),
+			finishCondition(),
+			job(),
+			jobWorkerCount(0),
+			runningCount(0),
+			generation(0),
+			stopping(false)
+	{
+	}
+
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		startCondition.notify_all();
+		for(auto & thread : threadList) {
+			thread.join();
+		}
+	}
+
+	// Run `job_` in `workerCount` worker threads, the workers get the indexes from 0 to workerCount - 1.
+	// It returns immediately, call wait() to wait for the workers to finish.
+	void start(const std::size_t workerCount, const Job & job_) {
+		std::lock_guard<std::mutex> lock(mutex);
+		while(threadList.size() < workerCount) {
+			const std::size_t workerIndex = threadList.size();
+			const std::size_t lastGeneration = generation;
+			threadList.emplace_back([this, workerIndex, lastGeneration]() {
+				run(workerIndex, lastGeneration);
+			});
+		}
+		job = job_;
+		jobWorkerCount = workerCount;
+		runningCount = workerCount;
+		++generation;
+		startCondition.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		finishCondition.wait(lock, [this]() {
+			return runningCount == 0;
+		});
+		job = Job();
+	}
+
+private:
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool & operator = (const WorkerPool &) = delete;
+
+	// `lastGeneration` is the generation before the job that starts the thread, so the thread runs that job.
+	void run(const std::size_t workerIndex, std::size_t lastGeneration) {
+		for(;;) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				startCondition.wait(lock, [this, lastGeneration]() {
+					return stopping || generation != lastGeneration;
+				});
+				if(stopping) {
+					return;
+				}
+				lastGeneration = generation;
+				if(workerIndex >= jobWorkerCount) {
+					continue;
+				}
+			}
+			job(workerIndex);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				--runningCount;
+				if(runningCount == 0) {
+					finishCondition.notify_all();
+				}
+			}
+		}
+	}
+
+private:
+	std::vector<std::thread> threadList;
+	std::mutex mutex;
+	std::condition_variable startCondition;
+	std::condition_variable finishCondition;
+	Job job;
+	std::size_t jobWorkerCount;
+	std::size_t runningCount;
+	// Increased for each job, so a worker runs each job once.
+	std::size_t generation;
+	bool stopping;
+};
+
+} // namespace internal_
+
+namespace {
+
+struct ChunkRange
+{
+	std::size_t begin;
+	std::size_t end;
+};
+
+// Each chunk ends right after a new line, except the last chunk.
+std::vector<ChunkRange> splitChunks(const char * text, const std::size_t length, const std::size_t chunkSize)
+{
+	std::vector<ChunkRange> chunkList;
+	std::size_t begin = 0;
+	while(begin < length) {
+		std::size_t end = begin + (chunkSize > 0 ? chunkSize : 1);
+		if(end >= length) {
+			end = length;
+		}
+		else {
+			const void * newLine = memchr(text + end, '\n', length - end);
+			end = (newLine == nullptr ? length : static_cast<const char *>(newLine) - text + 1);
+		}
+		chunkList.push_back({ begin, end });
+		begin = end;
+	}
+	return chunkList;
+}
+
+class ParallelParseTask
+{
+public:
+	ParallelParseTask(
+			const char * text,
+			const std::vector<ChunkRange> & chunkList,
+			const ParallelOrder order,
+			const std::size_t window,
+			const ParseManyCallback & callback,
+			const metapp::MetaType * prototype
+		)
+		:
+			text(text),
+			chunkList(chunkList),
+			order(order),
+			window(window),
+			callback(callback),
+			prototype(prototype),
+			mutex(),
+			deliverMutex(),
+			condition(),
+			nextChunk(0),
+			deliveredChunkCount(0),
+			resultList(order == ParallelOrder::inputOrder ? chunkList.size() : 0),
+			stopped(false),
+			errorMessage()
+	{
+	}
+
+	void work(Parser & parser) {
+		for(;;) {
+			std::size_t chunkIndex;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				if(order == ParallelOrder::inputOrder) {
+					// Don't run too far ahead of the delivery, otherwise the parsed documents of the whole input may be buffered.
+					condition.wait(lock, [this]() {
+						return stopped || nextChunk >= chunkList.size() || nextChunk < deliveredChunkCount + window;
+					});
+				}
+				if(stopped || nextChunk >= chunkList.size()) {
+					return;
+				}
+				chunkIndex = nextChunk++;
+			}
+
+			std::vector<metapp::Variant> valueList;
+			const ChunkRange & chunk = chunkList[chunkIndex];
+			const bool success = parser.parseMany(
+				ParserSource(text + chunk.begin, chunk.end - chunk.begin),
+				[&valueList](const metapp::Variant & value) -> bool {
+					valueList.push_back(value);
+					return true;
+				},
+				prototype
+			);
+			if(! success) {
+				stop(parser.getError());
+				return;
+			}
+
+			if(order == ParallelOrder::inputOrder) {
+				std::lock_guard<std::mutex> lock(mutex);
+				resultList[chunkIndex].valueList.swap(valueList);
+				resultList[chunkIndex].done = true;
+				condition.notify_all();
+			}
+			else {
+				std::lock_guard<std::mutex> lock(deliverMutex);
+				if(! deliver(valueList)) {
+					return;
+				}
+			}
+		}
+	}
+
+	// Called in the calling thread for ParallelOrder::inputOrder.
+	void deliverInOrder() {
+		while(deliveredChunkCount < chunkList.size()) {
+			std::vector<metapp::Variant> valueList;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this]() {
+					return stopped || resultList[deliveredChunkCount].done;
+				});
+				if(! resultList[deliveredChunkCount].done) {
+					return;
+				}
+				valueList.swap(resultList[deliveredChunkCount].valueList);
+				++deliveredChunkCount;
+				condition.notify_all();
+			}
+			if(! deliver(valueList)) {
+				return;
+			}
+		}
+	}
+
+	const std::string & getError() const {
+		return errorMessage;
+	}
+
+private:
+	struct ChunkResult
+	{
+		ChunkResult() : valueList(), done(false) {
+		}
+
+		std::vector<metapp::Variant> valueList;
+		bool done;
+	};
+
+	bool deliver(const std::vector<metapp::Variant> & valueList) {
+		try {
+			for(const auto & value : valueList) {
+				if(isStopped() || ! callback(value)) {
+					stop(std::string());
+					return false;
+				}
+			}
+		}
+		catch(const std::exception & e) {
+			stop(e.what());
+			return false;
+		}
+		return true;
+	}
+
+	bool isStopped() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return stopped;
+	}
+
+	void stop(const std::string & message) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(! stopped && errorMessage.empty()) {
+			errorMessage = message;
+		}
+		stopped = true;
+		condition.notify_all();
+	}
+
+private:
+	const char * text;
+	const std::vector<ChunkRange> & chunkList;
+	ParallelOrder order;
+	std::size_t window;
+	const ParseManyCallback & callback;
+	const metapp::MetaType * prototype;
+
+	std::mutex mutex;
+	// Serializes the callback for ParallelOrder::fastestFirst.
+	std::mutex deliverMutex;
+	std::condition_variable condition;
+	std::size_t nextChunk;
+	std::size_t deliveredChunkCount;
+	std::vector<ChunkResult> resultList;
+	bool stopped;
+	std::string errorMessage;
+};
+
+// Each worker takes the next unparsed document, so a few large documents don't leave the other workers idle.
+// The results are stored by index, so no lock is needed.
+class BatchParseTask
+{
+public:
+	BatchParseTask(
+			const ParserSource * sources,
+			const std::size_t count,
+			const metapp::MetaType * prototype,
+			std::vector<BatchParseResult> & resultList
+		)
+		:
+			sources(sources),
+			count(count),
+			prototype(prototype),
+			resultList(resultList),
+			nextIndex(0)
+	{
+	}
+
+	// `stats` is owned by the worker, the statistics of the workers are merged after they finish.
+	void work(Parser & parser, BatchParseStats & stats) {
+		for(;;) {
+			const std::size_t index = nextIndex++;
+			if(index >= count) {
+				return;
+			}
+
+			const auto startTime = std::chrono::steady_clock::now();
+			BatchParseResult & result = resultList[index];
+			result.value = parser.parse(sources[index], prototype);
+			if(parser.hasError()) {
+				result.value = metapp::Variant();
+				result.errorMessage = parser.getError();
+				++stats.failedCount;
+			}
+			const std::chrono::nanoseconds documentTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - startTime
+			);
+			stats.parseTime += documentTime;
+			stats.maxDocumentTime = (std::max)(stats.maxDocumentTime, documentTime);
+		}
+	}
+
+private:
+	const ParserSource * sources;
+	std::size_t count;
+	const metapp::MetaType * prototype;
+	std::vector<BatchParseResult> & resultList;
+	std::atomic<std::size_t> nextIndex;
+};
+
+// Returns true if a value of `metaType` may hold JsonStringView, such as a class field, a container element,
+// or a tuple element of JsonStringView. `visitedList` stops the recursion on classes that contain themselves.
+bool mayHoldStringView(const metapp::MetaType * metaType, std::vector<const metapp::MetaType *> & visitedList)
+{
+	if(metaType == nullptr) {
+		return false;
+	}
+	metaType = metapp::getNonReferenceMetaType(metaType);
+	if(metaType == metapp::getMetaType<JsonStringView>()) {
+		return true;
+	}
+	if(std::find(visitedList.begin(), visitedList.end(), metaType) != visitedList.end()) {
+		return false;
+	}
+	visitedList.push_back(metaType);
+	for(int i = 0; i < metaType->getUpTypeCount(); ++i) {
+		if(mayHoldStringView(metaType->getUpType(i), visitedList)) {
+			return true;
+		}
+	}
+	const metapp::MetaClass * metaClass = metaType->getMetaClass();
+	if(metaClass != nullptr) {
+		for(const auto & item : metaClass->getAccessibleView()) {
+			const metapp::Variant & accessible = item;
+			if(mayHoldStringView(metapp::accessibleGetValueType(accessible), visitedList)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool mayHoldStringView(const metapp::MetaType * metaType)
+{
+	std::vector<const metapp::MetaType *> visitedList;
+	return mayHoldStringView(metaType, visitedList);
+}
+
+} // namespace
+
+ParallelParser::ParallelParser()
+	: ParallelParser(ParserConfig())
+{
+}
+
+ParallelParser::ParallelParser(const ParserConfig & config, const std::size_t threadCount)
+	:
+		config(config),
+		threadCount(threadCount),
+		order(ParallelOrder::inputOrder),
+		chunkSize(1024 * 1024),
+		parserList(),
+		workerPool(new internal_::WorkerPool()),
+		errorMessage(),
+		batchStats()
+{
+	if(this->threadCount == 0) {
+		this->threadCount = std::thread::hardware_concurrency();
+	}
+	if(this->threadCount == 0) {
+		this->threadCount = 1;
+	}
+}
+
+ParallelParser::~ParallelParser()
+{
+}
+
+bool ParallelParser::hasError() const
+{
+	return ! errorMessage.empty();
+}
+
+const std::string & ParallelParser::getError() const
+{
+	return errorMessage;
+}
+
+bool ParallelParser::parseMany(
+		const char * jsonText,
+		const std::size_t length,
+		const ParseManyCallback & callback,
+		const metapp::MetaType * prototype
+	)
+{
+	errorMessage.clear();
+
+	// The documents of a chunk are buffered until the chunk is parsed, and for ParallelOrder::inputOrder, until the
+	// previous chunks are delivered. The parser has parsed other documents by then, so a JsonStringView would dangle.
+	if(mayHoldStringView(prototype)) {
+		errorMessage = "ParallelParser::parseMany doesn't support JsonStringView in the prototype, it would refer to the memory of another document.";
+		return false;
+	}
+
+	const std::vector<ChunkRange> chunkList = splitChunks(jsonText, length, chunkSize);
+	const std::size_t workerCount = (std::min)(threadCount, chunkList.size());
+	prepareParsers((std::max)(workerCount, std::size_t(1)));
+
+	if(workerCount <= 1) {
+		Parser & parser = *parserList[0];
+		const bool success = parser.parseMany(ParserSource(jsonText, length), callback, prototype);
+		errorMessage = parser.getError();
+		return success;
+	}
+
+	ParallelParseTask task(jsonText, chunkList, order, workerCount * 2, callback, prototype);
+	workerPool->start(workerCount, [this, &task](const std::size_t workerIndex) {
+		task.work(*parserList[workerIndex]);
+	});
+	if(order == ParallelOrder::inputOrder) {
+		task.deliverInOrder();
+	}
+	workerPool->wait();
+	errorMessage = task.getError();
+	return ! hasError();
+}
+
+bool ParallelParser::parseMany(const std::string & jsonText, const ParseManyCallback & callback, const metapp::MetaType * prototype)
+{
+	return parseMany(jsonText.data(), jsonText.size(), callback, prototype);
+}
+
+std::vector<BatchParseResult> ParallelParser::parseBatch(
+		const ParserSource * sources,
+		const std::size_t count,
+		const metapp::MetaType * prototype
+	)
+{
+	errorMessage.clear();
+	batchStats = BatchParseStats();
+
+	const auto startTime = std::chrono::steady_clock::now();
+	std::vector<BatchParseResult> resultList(count);
+
+	if(mayHoldStringView(prototype)) {
+		errorMessage = "parseBatch doesn't support JsonStringView in the prototype, it would refer to the memory of another document.";
+		for(auto & result : resultList) {
+			result.errorMessage = errorMessage;
+		}
+		batchStats.documentCount = count;
+		batchStats.failedCount = count;
+		return resultList;
+	}
+
+	const std::size_t workerCount = (std::max)((std::min)(threadCount, count), std::size_t(1));
+	prepareParsers(workerCount);
+
+	BatchParseTask task(sources, count, prototype, resultList);
+	std::vector<BatchParseStats> workerStatsList(workerCount);
+	if(workerCount == 1) {
+		task.work(*parserList[0], workerStatsList[0]);
+	}
+	else {
+		workerPool->start(workerCount, [this, &task, &workerStatsList](const std::size_t workerIndex) {
+			task.work(*parserList[workerIndex], workerStatsList[workerIndex]);
+		});
+		workerPool->wait();
+	}
+
+	batchStats.documentCount = count;
+	batchStats.threadCount = workerCount;
+	for(std::size_t i = 0; i < count; ++i) {
+		batchStats.byteCount += sources[i].getTextLength();
+	}
+	for(const auto & workerStats : workerStatsList) {
+		batchStats.failedCount += workerStats.failedCount;
+		batchStats.parseTime += workerStats.parseTime;
+		batchStats.maxDocumentTime = (std::max)(batchStats.maxDocumentTime, workerStats.maxDocumentTime);
+	}
+	batchStats.elapsedTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - startTime
+	);
+
+	for(const auto & result : resultList) {
+		if(! result.errorMessage.empty()) {
+			errorMessage = result.errorMessage;
+			break;
+		}
+	}
+	return resultList;
+}
+
+std::vector<BatchParseResult> ParallelParser::parseBatch(const std::vector<ParserSource> & sources, const metapp::MetaType * prototype)
+{
+	return parseBatch(sources.data(), sources.size(), prototype);
+}
+
+// The parsers are kept for the next calls, so each worker reuses the memory of its parser backend.
+void ParallelParser::prepareParsers(const std::size_t count)
+{
+	while(parserList.size() < count) {
+		parserList.emplace_back(new Parser(config));
+	}
+}
+
+
+} // namespace jsonpp
@@ -16,6 +16,7 @@
 
 #include "jsonpp/parser.h"
 #include "jsonpp/parserbackend.h"
+#include "jsonpp/implement/typecache_i.h"
 
 #include "metapp/allmetatypes.h"
 #include "metapp/interfaces/metaclass.h"
@@ -26,6 +27,15 @@
 #include <array>
 #include <limits>
 #include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #ifndef JSONPP_DEFAULT_PARSER_BACKEND
 #define JSONPP_DEFAULT_PARSER_BACKEND simdjson
@@ -37,6 +47,126 @@ namespace internal_ {
 
 std::unique_ptr<ParserBackend> createBackend_cparser(const ParserConfig & config);
 std::unique_ptr<ParserBackend> createBackend_simdjsonDom(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_simdjsonOnDemand(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_native(const ParserConfig & config);
+std::unique_ptr<ParserBackend> createBackend_automatic(const ParserConfig & config);
+
+ClassParsePlan::ClassParsePlan(const metapp::MetaClass * metaClass)
+	: fieldList(), slotList(), slotMask(0)
+{
+	const auto fieldView = metaClass->getAccessibleView();
+	for(const auto & item : fieldView) {
+		const std::string & name = item.getName();
+		// The derived class field hides the base class field of the same name, same as MetaClass::getAccessible.
+		const bool exists = std::any_of(fieldList.begin(), fieldList.end(), [&name](const Field & field) {
+			return field.name == name;
+		});
+		if(! exists) {
+			const metapp::Variant & accessible = item;
+			const metapp::MetaType * valueType = metapp::accessibleGetValueType(accessible);
+			const bool scalar = internal_::isScalarTypeKind(metapp::getNonReferenceMetaType(valueType)->getTypeKind());
+			fieldList.push_back({ name, accessible, valueType, scalar });
+		}
+	}
+
+	if(fieldList.empty()) {
+		return;
+	}
+	// Keep the load factor below 0.5
+	std::size_t slotCount = 8;
+	while(slotCount < fieldList.size() * 2) {
+		slotCount <<= 1;
+	}
+	slotList.resize(slotCount);
+	slotMask = slotCount - 1;
+	for(std::size_t i = 0; i < fieldList.size(); ++i) {
+		const std::string & name = fieldList[i].name;
+		std::size_t slot = static_cast<std::size_t>(hashKey(name.data(), name.size())) & slotMask;
+		while(slotList[slot] != 0) {
+			slot = (slot + 1) & slotMask;
+		}
+		slotList[slot] = static_cast<uint32_t>(i + 1);
+	}
+}
+
+const ClassParsePlan * getClassParsePlan(const metapp::MetaClass * metaClass)
+{
+	using Cache = TypeCache<const metapp::MetaClass *, ClassParsePlan>;
+	static Cache cache;
+	thread_local Cache::ThreadMap threadMap;
+
+	return cache.get(threadMap, metaClass, [](const metapp::MetaClass * metaClass) {
+		return std::unique_ptr<ClassParsePlan>(new ClassParsePlan(metaClass));
+	});
+}
+
+namespace {
+
+bool isNumberTypeKind(const metapp::TypeKind typeKind)
+{
+	return isScalarTypeKind(typeKind)
+		&& typeKind != metapp::getTypeKind<bool>()
+		&& typeKind != metapp::getTypeKind<std::string>()
+	;
+}
+
+const char * getElementAddress(const metapp::MetaIndexable * metaIndexable, const metapp::Variant & container, const std::size_t index)
+{
+	return static_cast<const char *>(metaIndexable->get(container, index).getAddress());
+}
+
+std::unique_ptr<NumericArrayLayout> createNumericArrayLayout(const metapp::MetaType * metaType)
+{
+	// std::deque and std::list are not contiguous, std::vector<bool> is not an array of bool.
+	if(metaType->getTypeKind() != metapp::tkStdVector) {
+		return nullptr;
+	}
+	const metapp::MetaType * elementType = metapp::getNonReferenceMetaType(metaType->getUpType());
+	const metapp::MetaType * numberType = elementType;
+	std::size_t groupSize = 0;
+	if(elementType->getTypeKind() == metapp::tkStdArray) {
+		numberType = metapp::getNonReferenceMetaType(elementType->getUpType());
+		groupSize = elementType->getMetaIndexable()->getSizeInfo(metapp::Variant(elementType, nullptr)).getSize();
+		if(groupSize == 0) {
+			return nullptr;
+		}
+	}
+	if(! isNumberTypeKind(numberType->getTypeKind())) {
+		return nullptr;
+	}
+
+	// Verify the numbers are contiguous using a sample vector, instead of assuming the layout of std::array.
+	const metapp::MetaIndexable * metaIndexable = metaType->getMetaIndexable();
+	metapp::Variant sample(metaType, nullptr);
+	metaIndexable->resize(sample, 2);
+	const char * first = getElementAddress(metaIndexable, sample, 0);
+	const std::size_t stride = static_cast<std::size_t>(getElementAddress(metaIndexable, sample, 1) - first);
+	if(groupSize > 0) {
+		if(stride % groupSize != 0) {
+			return nullptr;
+		}
+		const std::size_t numberSize = stride / groupSize;
+		const metapp::MetaIndexable * elementIndexable = elementType->getMetaIndexable();
+		const metapp::Variant element = metaIndexable->get(sample, 0);
+		if(getElementAddress(elementIndexable, element, 0) != first
+			|| getElementAddress(elementIndexable, element, groupSize - 1) != first + numberSize * (groupSize - 1)) {
+			return nullptr;
+		}
+	}
+
+	return std::unique_ptr<NumericArrayLayout>(new NumericArrayLayout { numberType->getTypeKind(), groupSize });
+}
+
+} // namespace
+
+const NumericArrayLayout * getNumericArrayLayout(const metapp::MetaType * metaType)
+{
+	using Cache = TypeCache<const metapp::MetaType *, NumericArrayLayout>;
+	static Cache cache;
+	thread_local Cache::ThreadMap threadMap;
+
+	return cache.get(threadMap, metaType, &createNumericArrayLayout);
+}
 
 } // namespace internal_
 
@@ -75,7 +205,9 @@ JsonType getJsonType(const metapp::Variant & var)
 		break;
 
 	default:
-		if(metaType->equal(metapp::getMetaType<JsonObject>())) {
+		if(metaType->equal(metapp::getMetaType<JsonObject>())
+			|| metaType->equal(metapp::getMetaType<JsonHashObject>())
+			|| metaType->equal(metapp::getMetaType<JsonFlatObject>())) {
 			return JsonType::jtObject;
 		}
 		break;
@@ -93,18 +225,44 @@ std::string getParserBackendName(const ParserBackendType type)
 
 	case ParserBackendType::simdjson:
 		return "simdjson";
+
+	case ParserBackendType::simdjsonOnDemand:
+		return "simdjson ondemand";
+
+	case ParserBackendType::native:
+		return "native";
+
+	case ParserBackendType::automatic:
+		return "automatic";
 	}
 
 	return "Unknown";
 }
 
+AutoBackendThresholds::AutoBackendThresholds()
+	:
+		smallSize(512),
+		largeSize(64 * 1024),
+		largeSparseSize(4 * 1024)
+{
+}
+
 ParserConfig::ParserConfig()
 	:
 		backendType(),
 		backendCreator(nullptr),
 		comment(false),
+		batchSize(1000000),
+		zeroCopyString(false),
 		arrayType(),
-		objectType()
+		objectType(),
+		stringPool(),
+		initialCapacity(0),
+		maxCapacity(0),
+		releaseMemorySize(0),
+		hugePages(false),
+		autoThresholds(),
+		keyFilter()
 {
 	setBackendType<ParserBackendType::JSONPP_DEFAULT_PARSER_BACKEND>();
 }
@@ -113,47 +271,84 @@ ParserConfig::~ParserConfig()
 {
 }
 
+constexpr int ParserConfig::anyDepth;
+
+ParserConfig & ParserConfig::includeKeys(const std::vector<std::string> & keys, const int depth)
+{
+	keyFilter = std::make_shared<internal_::KeyFilter>(keyFilter ? *keyFilter : internal_::KeyFilter());
+	keyFilter->include(keys, depth);
+	return *this;
+}
+
+ParserConfig & ParserConfig::excludeKeys(const std::vector<std::string> & keys, const int depth)
+{
+	keyFilter = std::make_shared<internal_::KeyFilter>(keyFilter ? *keyFilter : internal_::KeyFilter());
+	keyFilter->exclude(keys, depth);
+	return *this;
+}
+
 ParserSource::ParserSource()
 	:
-		prepared(false),
 		storageType(StorageType::string),
 		cstr(nullptr),
 		cstrLength(0),
+		cstrCapacity(0),
 		ref(nullptr),
-		str()
+		str(),
+		buffer(),
+		errorMessage()
 {
 }
 
 ParserSource::ParserSource(const char * cstr, const std::size_t cstrLength)
 	:
-		prepared(false),
 		storageType(StorageType::cstr),
 		cstr(cstr),
 		cstrLength(cstrLength),
+		cstrCapacity(cstrLength),
+		ref(nullptr),
+		str(),
+		buffer(),
+		errorMessage()
+{
+}
+
+ParserSource::ParserSource(const char * cstr, const std::size_t cstrLength, const std::size_t capacity)
+	:
+		storageType(StorageType::cstr),
+		cstr(cstr),
+		cstrLength(cstrLength),
+		cstrCapacity(capacity < cstrLength ? cstrLength : capacity),
 		ref(nullptr),
-		str()
+		str(),
+		buffer(),
+		errorMessage()
 {
 }
 
 ParserSource::ParserSource(const std::string & str)
 	:
-		prepared(false),
 		storageType(StorageType::ref),
 		cstr(nullptr),
 		cstrLength(0),
+		cstrCapacity(0),
 		ref(&str),
-		str()
+		str(),
+		buffer(),
+		errorMessage()
 {
 }
 
 ParserSource::ParserSource(std::string && str)
 	:
-		prepared(false),
 		storageType(StorageType::string),
 		cstr(nullptr),
 		cstrLength(0),
+		cstrCapacity(0),
 		ref(nullptr),
-		str(std::move(str))
+		str(std::move(str)),
+		buffer(),
+		errorMessage()
 {
 }
 
@@ -189,7 +384,7 @@ std::size_t ParserSource::getCapacity() const
 {
 	switch(storageType) {
 	case StorageType::cstr:
-		return cstrLength;
+		return cstrCapacity;
 
 	case StorageType::ref:
 		return ref->capacity();
@@ -203,12 +398,15 @@ void ParserSource::pad(const std::size_t size) const
 {
 	switch(storageType) {
 	case StorageType::cstr: {
-		str.resize(cstrLength);
-		str.reserve(cstrLength + size);
-		memmove(&str[0], cstr, cstrLength);
-		str[cstrLength] = 0;
-		cstr = nullptr;
-		storageType = StorageType::string;
+		if(cstrCapacity < cstrLength + size) {
+			str.resize(cstrLength);
+			str.reserve(cstrLength + size);
+			memmove(&str[0], cstr, cstrLength);
+			str[cstrLength] = 0;
+			cstr = nullptr;
+			buffer.reset();
+			storageType = StorageType::string;
+		}
 		break;
 	}
 
@@ -233,13 +431,105 @@ void ParserSource::pad(const std::size_t size) const
 	}
 }
 
+namespace {
+
+#if !defined(_WIN32)
+// Map the file if the slack after the end of file in the last page, which is readable and filled with zeros,
+// covers the padding. Returns nullptr if the file can't be mapped that way.
+std::shared_ptr<const char> mapFile(const std::string & fileName, std::size_t & length, std::size_t & capacity)
+{
+	const int fd = open(fileName.c_str(), O_RDONLY);
+	if(fd < 0) {
+		return nullptr;
+	}
+	std::shared_ptr<const char> result;
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+		const std::size_t fileSize = static_cast<std::size_t>(fileStat.st_size);
+		const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		const std::size_t slack = (pageSize - fileSize % pageSize) % pageSize;
+		if(slack >= ParserSource::filePadding) {
+			void * address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(address != MAP_FAILED) {
+				madvise(address, fileSize, MADV_SEQUENTIAL);
+				result.reset(static_cast<const char *>(address), [fileSize](const char * p) {
+					munmap(const_cast<char *>(p), fileSize);
+				});
+				length = fileSize;
+				capacity = fileSize + slack;
+			}
+		}
+	}
+	close(fd);
+	return result;
+}
+#endif
+
+std::shared_ptr<const char> readFile(const std::string & fileName, std::size_t & length, std::size_t & capacity)
+{
+	std::ifstream file(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+	if(! file) {
+		return nullptr;
+	}
+	const std::streamoff fileSize = file.tellg();
+	if(fileSize < 0) {
+		return nullptr;
+	}
+	file.seekg(0);
+	length = static_cast<std::size_t>(fileSize);
+	capacity = length + ParserSource::filePadding;
+	char * data = new char[capacity];
+	std::shared_ptr<const char> result(data, std::default_delete<char[]>());
+	if(! file.read(data, static_cast<std::streamsize>(length))) {
+		return nullptr;
+	}
+	std::fill(data + length, data + capacity, 0);
+	return result;
+}
+
+} // namespace
+
+constexpr std::size_t ParserSource::filePadding;
+
+ParserSource ParserSource::fromFile(const std::string & fileName)
+{
+	ParserSource source;
+	std::size_t length = 0;
+	std::size_t capacity = 0;
+#if !defined(_WIN32)
+	source.buffer = mapFile(fileName, length, capacity);
+#endif
+	if(! source.buffer) {
+		source.buffer = readFile(fileName, length, capacity);
+	}
+	if(! source.buffer) {
+		source.errorMessage = "Can't read file " + fileName;
+		return source;
+	}
+	source.storageType = StorageType::cstr;
+	source.cstr = source.buffer.get();
+	source.cstrLength = length;
+	source.cstrCapacity = capacity;
+	return source;
+}
+
+bool ParserSource::hasError() const
+{
+	return ! errorMessage.empty();
+}
+
+const std::string & ParserSource::getError() const
+{
+	return errorMessage;
+}
+
 Parser::Parser()
 	: Parser(ParserConfig())
 {
 }
 
 Parser::Parser(const ParserConfig & config)
-	: backend(config.getBackendCreator()(config)), errorMessage()
+	: backend(config.getBackendCreator()(config)), releaseMemorySize(config.getReleaseMemorySize()), errorMessage()
 {
 }
 
@@ -257,29 +547,60 @@ const std::string & Parser::getError() const
 	return errorMessage;
 }
 
-metapp::Variant Parser::parse(const char * jsonText, const std::size_t length, const metapp::MetaType * proto)
+std::size_t Parser::getMemorySize() const
 {
-	return parse(ParserSource(jsonText, length), proto);
+	return backend->getMemorySize() + scratchBuffer.capacity();
 }
 
-metapp::Variant Parser::parse(const std::string & jsonText, const metapp::MetaType * proto)
+void Parser::releaseMemory()
 {
-	return parse(ParserSource(jsonText), proto);
+	backend->releaseMemory();
+	std::string().swap(scratchBuffer);
 }
 
-metapp::Variant Parser::parse(const ParserSource & source, const metapp::MetaType * proto)
+template <typename Callback>
+metapp::Variant Parser::doParse(const ParserSource & source, const Callback & callback)
 {
 	errorMessage.clear();
 
-	if(! source.hasPrepared()) {
-		source.setAsPrepared();
-		backend->prepareSource(source);
+	if(source.hasError()) {
+		errorMessage = source.getError();
+		return metapp::Variant();
+	}
+
+	// The memory grown by the previous parse is released here instead of right after that parse,
+	// because the JsonStringView values in its result refer to the memory until the next parse.
+	if(releaseMemorySize > 0 && getMemorySize() > releaseMemorySize) {
+		releaseMemory();
 	}
 
+	const std::size_t padding = backend->getPadding();
+	const std::size_t length = source.getTextLength();
+	const ParserSource * paddedSource = &source;
+	ParserSource scratchSource;
+	if(source.getCapacity() < length + padding) {
+		if(source.storageType == ParserSource::StorageType::string) {
+			source.pad(padding);
+		}
+		else {
+			// Don't let the borrowed source refer to the scratch buffer, the buffer is overwritten by the next parse.
+			if(scratchBuffer.size() < length + padding) {
+				scratchBuffer.resize(length + padding);
+			}
+			if(length > 0) {
+				memcpy(&scratchBuffer[0], source.getText(), length);
+			}
+			std::fill(&scratchBuffer[0] + length, &scratchBuffer[0] + length + padding, 0);
+			scratchSource = ParserSource(&scratchBuffer[0], length, length + padding);
+			paddedSource = &scratchSource;
+		}
+	}
+
+	metapp::Variant result;
 	try {
-		ParserBackendResult result = backend->parse(source, proto);
-		errorMessage = std::move(result.errorMessage);
-		return result.value;
+		ParserBackendResult backendResult = callback(*paddedSource);
+		errorMessage = std::move(backendResult.errorMessage);
+		result = std::move(backendResult.value);
 	}
 	catch(const metapp::MetaException & e) {
 		errorMessage = e.what();
@@ -287,7 +608,136 @@ metapp::Variant Parser::parse(const ParserSource & source, const metapp::MetaTyp
 	catch(const std::exception & e) {
 		errorMessage = e.what();
 	}
-	return metapp::Variant();
+	return result;
+}
+
+metapp::Variant Parser::parse(const char * jsonText, const std::size_t length, const metapp::MetaType * proto)
+{
+	return parse(ParserSource(jsonText, length), proto);
+}
+
+metapp::Variant Parser::parse(const std::string & jsonText, const metapp::MetaType * proto)
+{
+	return parse(ParserSource(jsonText), proto);
+}
+
+metapp::Variant Parser::parse(const ParserSource & source, const metapp::MetaType * proto)
+{
+	return doParse(source, [this, proto](const ParserSource & source) {
+		return backend->parse(source, proto);
+	});
+}
+
+metapp::Variant Parser::doParseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return doParse(source, [this, &target](const ParserSource & source) {
+		return backend->parseInto(source, target);
+	});
+}
+
+bool Parser::parseMany(
+		const char * jsonText,
+		const std::size_t length,
+		const ParseManyCallback & callback,
+		const metapp::MetaType * prototype
+	)
+{
+	return parseMany(ParserSource(jsonText, length), callback, prototype);
+}
+
+bool Parser::parseMany(const std::string & jsonText, const ParseManyCallback & callback, const metapp::MetaType * prototype)
+{
+	return parseMany(ParserSource(jsonText), callback, prototype);
+}
+
+bool Parser::parseMany(const ParserSource & source, const ParseManyCallback & callback, const metapp::MetaType * prototype)
+{
+	doParse(source, [this, &callback, prototype](const ParserSource & source) {
+		return backend->parseMany(source, prototype, callback);
+	});
+	return ! hasError();
+}
+
+std::vector<metapp::Variant> Parser::extract(
+		const char * jsonText,
+		const std::size_t length,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes
+	)
+{
+	return extract(ParserSource(jsonText, length), pointers, prototypes);
+}
+
+std::vector<metapp::Variant> Parser::extract(
+		const std::string & jsonText,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes
+	)
+{
+	return extract(ParserSource(jsonText), pointers, prototypes);
+}
+
+std::vector<metapp::Variant> Parser::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes
+	)
+{
+	std::vector<metapp::Variant> results(pointers.size());
+	doParse(source, [this, &pointers, &prototypes, &results](const ParserSource & source) -> ParserBackendResult {
+		for(const auto & pointer : pointers) {
+			if(! internal_::iterateJsonPointer(pointer, [](const std::string &) { return true; })) {
+				return { metapp::Variant(), "Invalid JSON pointer " + pointer };
+			}
+		}
+		std::vector<const metapp::MetaType *> prototypeList(prototypes);
+		prototypeList.resize(pointers.size(), nullptr);
+		return backend->extract(source, pointers, prototypeList, results);
+	});
+	if(hasError()) {
+		results.assign(pointers.size(), metapp::Variant());
+	}
+	return results;
+}
+
+bool Parser::visit(const char * jsonText, const std::size_t length, ParserHandler & handler)
+{
+	return visit(ParserSource(jsonText, length), handler);
+}
+
+bool Parser::visit(const std::string & jsonText, ParserHandler & handler)
+{
+	return visit(ParserSource(jsonText), handler);
+}
+
+bool Parser::visit(const ParserSource & source, ParserHandler & handler)
+{
+	doParse(source, [this, &handler](const ParserSource & source) {
+		return backend->visit(source, handler);
+	});
+	return ! hasError();
+}
+
+bool Parser::parseDocument(const char * jsonText, const std::size_t length, JsonDocument & document)
+{
+	return parseDocument(ParserSource(jsonText, length), document);
+}
+
+bool Parser::parseDocument(const std::string & jsonText, JsonDocument & document)
+{
+	return parseDocument(ParserSource(jsonText), document);
+}
+
+bool Parser::parseDocument(const ParserSource & source, JsonDocument & document)
+{
+	doParse(source, [this, &document](const ParserSource & source) {
+		return backend->parseDocument(source, document);
+	});
+	if(hasError()) {
+		document.clear();
+		return false;
+	}
+	return true;
 }
 
 
@@ -0,0 +1,172 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "jsonpp/parserpool.h"
+
+#include <thread>
+#include <utility>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+struct ParserPoolSlot
+{
+	ParserPoolSlot() : parser(), memorySize(0), next(0) {
+	}
+
+	std::unique_ptr<Parser> parser;
+	std::size_t memorySize;
+	// The slot index + 1 of the next slot in the stack.
+	std::atomic<uint32_t> next;
+};
+
+} // namespace internal_
+
+namespace {
+
+uint64_t makeHead(const uint64_t oldHead, const uint32_t index)
+{
+	return (((oldHead >> 32) + 1) << 32) | index;
+}
+
+// Returns the slot index + 1, or 0 if the stack is empty.
+uint32_t popSlot(std::atomic<uint64_t> & head, internal_::ParserPoolSlot * slotList)
+{
+	uint64_t oldHead = head.load(std::memory_order_acquire);
+	for(;;) {
+		const uint32_t index = static_cast<uint32_t>(oldHead);
+		if(index == 0) {
+			return 0;
+		}
+		// If the slot is popped and pushed by another thread after `oldHead` is loaded, `next` may be stale,
+		// then the tag in the head is changed and the exchange fails.
+		const uint32_t next = slotList[index - 1].next.load(std::memory_order_relaxed);
+		if(head.compare_exchange_weak(oldHead, makeHead(oldHead, next), std::memory_order_acquire, std::memory_order_acquire)) {
+			return index;
+		}
+	}
+}
+
+void pushSlot(std::atomic<uint64_t> & head, internal_::ParserPoolSlot * slotList, const uint32_t index)
+{
+	uint64_t oldHead = head.load(std::memory_order_relaxed);
+	for(;;) {
+		slotList[index - 1].next.store(static_cast<uint32_t>(oldHead), std::memory_order_relaxed);
+		if(head.compare_exchange_weak(oldHead, makeHead(oldHead, index), std::memory_order_release, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+} // namespace
+
+ParserPool::Lease::~Lease()
+{
+	if(parser != nullptr) {
+		pool->release(parser);
+	}
+}
+
+ParserPool::ParserPool(const ParserConfig & config, const std::size_t maxIdleCount)
+	:
+		config(config),
+		maxIdleCount(maxIdleCount),
+		memoryCeiling(0),
+		slotList(),
+		idleHead(0),
+		emptyHead(0),
+		inUseCount(0),
+		idleCount(0),
+		idleMemorySize(0),
+		createdCount(0),
+		trimmedCount(0)
+{
+	if(this->maxIdleCount == 0) {
+		this->maxIdleCount = std::thread::hardware_concurrency();
+		if(this->maxIdleCount == 0) {
+			this->maxIdleCount = 1;
+		}
+	}
+	slotList.reset(new internal_::ParserPoolSlot[this->maxIdleCount]);
+	for(std::size_t i = 0; i < this->maxIdleCount; ++i) {
+		pushSlot(emptyHead, slotList.get(), static_cast<uint32_t>(i + 1));
+	}
+}
+
+ParserPool::~ParserPool()
+{
+}
+
+ParserPool::Lease ParserPool::acquire()
+{
+	Parser * parser = nullptr;
+	const uint32_t index = popSlot(idleHead, slotList.get());
+	if(index != 0) {
+		internal_::ParserPoolSlot & slot = slotList[index - 1];
+		parser = slot.parser.release();
+		idleMemorySize.fetch_sub(slot.memorySize, std::memory_order_relaxed);
+		idleCount.fetch_sub(1, std::memory_order_relaxed);
+		pushSlot(emptyHead, slotList.get(), index);
+	}
+	else {
+		parser = new Parser(config);
+		createdCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	inUseCount.fetch_add(1, std::memory_order_relaxed);
+	return Lease(this, parser);
+}
+
+void ParserPool::release(Parser * parser)
+{
+	std::unique_ptr<Parser> holder(parser);
+	inUseCount.fetch_sub(1, std::memory_order_relaxed);
+
+	std::size_t memorySize = parser->getMemorySize();
+	const std::size_t ceiling = memoryCeiling.load(std::memory_order_relaxed);
+	if(ceiling > 0 && memorySize > ceiling) {
+		parser->releaseMemory();
+		memorySize = parser->getMemorySize();
+		trimmedCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const uint32_t index = popSlot(emptyHead, slotList.get());
+	if(index == 0) {
+		// The pool is full, the parser is destroyed.
+		return;
+	}
+	internal_::ParserPoolSlot & slot = slotList[index - 1];
+	slot.parser = std::move(holder);
+	slot.memorySize = memorySize;
+	idleMemorySize.fetch_add(memorySize, std::memory_order_relaxed);
+	idleCount.fetch_add(1, std::memory_order_relaxed);
+	pushSlot(idleHead, slotList.get(), index);
+}
+
+ParserPool::Stats ParserPool::getStats() const
+{
+	return {
+		inUseCount.load(std::memory_order_relaxed),
+		idleCount.load(std::memory_order_relaxed),
+		idleMemorySize.load(std::memory_order_relaxed),
+		createdCount.load(std::memory_order_relaxed),
+		trimmedCount.load(std::memory_order_relaxed)
+	};
+}
+
+
+} // namespace jsonpp
@@ -0,0 +1,340 @@
+// jsonpp library
+//
+// Copyright (C) 2022 Wang Qi (wqking)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/parser.h"
+#include "jsonpp/parserbackend.h"
+
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <limits>
+
+namespace jsonpp {
+
+namespace internal_ {
+
+namespace {
+
+// Only the beginning of the document is sampled, so choosing the backend costs the same for any document size.
+constexpr std::size_t autoSampleSize = 1024;
+
+// Returns true if most of the sampled bytes are in strings or are white spaces, such as documents of long texts
+// or pretty printed documents. The SIMD scan of simdjson gains more on such documents.
+bool isSparseDocument(const char * text, const std::size_t length)
+{
+	const std::size_t sampleSize = (std::min)(length, autoSampleSize);
+	std::size_t sparseCount = 0;
+	bool inString = false;
+	for(std::size_t i = 0; i < sampleSize; ++i) {
+		const char c = text[i];
+		if(inString) {
+			++sparseCount;
+			if(c == '\\') {
+				++i;
+				++sparseCount;
+			}
+			else if(c == '"') {
+				inString = false;
+			}
+		}
+		else if(c == '"') {
+			inString = true;
+		}
+		else if(c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+			++sparseCount;
+		}
+	}
+	return sparseCount * 4 > sampleSize * 3;
+}
+
+} // namespace
+
+// Forwards each call to backend cparser, native or simdjson, chosen by the size and shape of the document.
+// All backends are created up front so getPadding covers them, they don't allocate the parse buffers until they are used,
+// unless ParserConfig::setInitialCapacity is set.
+class BackendAutomatic : public ParserBackend
+{
+public:
+	explicit BackendAutomatic(const ParserConfig & config);
+	~BackendAutomatic();
+
+	ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+	ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) override;
+	ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) override;
+	ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) override;
+	ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) override;
+	ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) override;
+	std::size_t getMemorySize() const override;
+	void releaseMemory() override;
+	std::size_t getPadding() const override;
+
+private:
+	ParserBackend & chooseBackend(const ParserSource & source) const;
+
+private:
+	ParserConfig config;
+	std::unique_ptr<ParserBackend> smallBackend;
+	std::unique_ptr<ParserBackend> mediumBackend;
+	std::unique_ptr<ParserBackend> largeBackend;
+};
+
+BackendAutomatic::BackendAutomatic(const ParserConfig & config)
+	:
+		config(config),
+		smallBackend(createBackend_cparser(config)),
+		mediumBackend(createBackend_native(config)),
+		largeBackend(createBackend_simdjsonDom(config))
+{
+}
+
+BackendAutomatic::~BackendAutomatic()
+{
+}
+
+ParserBackend & BackendAutomatic::chooseBackend(const ParserSource & source) const
+{
+	// Only cparser supports comments, the result must not depend on the document size.
+	if(config.allowComment()) {
+		return *smallBackend;
+	}
+
+	const AutoBackendThresholds & thresholds = config.getAutoThresholds();
+	const std::size_t length = source.getTextLength();
+	if(length < thresholds.smallSize) {
+		return *smallBackend;
+	}
+	if(length >= (std::max)(thresholds.largeSize, thresholds.largeSparseSize)) {
+		return *largeBackend;
+	}
+	if(length < (std::min)(thresholds.largeSize, thresholds.largeSparseSize)) {
+		return *mediumBackend;
+	}
+	const std::size_t largeSize = isSparseDocument(source.getText(), length)
+		? thresholds.largeSparseSize
+		: thresholds.largeSize
+	;
+	return length >= largeSize ? *largeBackend : *mediumBackend;
+}
+
+ParserBackendResult BackendAutomatic::parse(const ParserSource & source, const metapp::MetaType * prototype)
+{
+	return chooseBackend(source).parse(source, prototype);
+}
+
+ParserBackendResult BackendAutomatic::parseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return chooseBackend(source).parseInto(source, target);
+}
+
+ParserBackendResult BackendAutomatic::parseDocument(const ParserSource & source, JsonDocument & document)
+{
+	return chooseBackend(source).parseDocument(source, document);
+}
+
+ParserBackendResult BackendAutomatic::parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	)
+{
+	return chooseBackend(source).parseMany(source, prototype, callback);
+}
+
+ParserBackendResult BackendAutomatic::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	)
+{
+	return chooseBackend(source).extract(source, pointers, prototypes, results);
+}
+
+ParserBackendResult BackendAutomatic::visit(const ParserSource & source, ParserHandler & handler)
+{
+	return chooseBackend(source).visit(source, handler);
+}
+
+std::size_t BackendAutomatic::getMemorySize() const
+{
+	return smallBackend->getMemorySize() + mediumBackend->getMemorySize() + largeBackend->getMemorySize();
+}
+
+void BackendAutomatic::releaseMemory()
+{
+	smallBackend->releaseMemory();
+	mediumBackend->releaseMemory();
+	largeBackend->releaseMemory();
+}
+
+std::size_t BackendAutomatic::getPadding() const
+{
+	return (std::max)({ smallBackend->getPadding(), mediumBackend->getPadding(), largeBackend->getPadding() });
+}
+
+std::unique_ptr<ParserBackend> createBackend_automatic(const ParserConfig & config)
+{
+	return std::unique_ptr<ParserBackend>(new BackendAutomatic(config));
+}
+
+namespace {
+
+// The bytes parsed in each measurement, the time is the best of `calibrateRounds` rounds.
+constexpr std::size_t calibrateBytes = 512 * 1024;
+constexpr int calibrateRounds = 3;
+constexpr std::size_t calibrateMinSize = 64;
+constexpr std::size_t calibrateMaxSize = 1024 * 1024;
+
+enum class CalibrateShape
+{
+	dense,
+	sparse
+};
+
+// Generate an array of at least `size` bytes. The dense shape is compact numbers and short keys,
+// the sparse shape is pretty printed objects with long strings.
+std::string makeCalibrateDocument(const CalibrateShape shape, const std::size_t size)
+{
+	std::string text = "[";
+	for(int i = 0; text.size() < size; ++i) {
+		if(i > 0) {
+			text += ",";
+		}
+		if(shape == CalibrateShape::dense) {
+			text += "{\"id\":" + std::to_string(i * 7919) + ",\"v\":[" + std::to_string(i % 100) + ",-2.5,3],\"ok\":true}";
+		}
+		else {
+			text += "\n    {\n        \"name\" : \"item " + std::to_string(i) + "\",\n"
+				"        \"text\" : \"The quick brown fox jumps over the lazy dog, then it runs back to the forest.\"\n"
+				"    }"
+			;
+		}
+	}
+	text += "]";
+	return text;
+}
+
+// Returns the best nanoseconds per parse of `text`.
+double measureBackend(ParserBackend & backend, const std::string & text)
+{
+	std::string buffer(text);
+	buffer.resize(text.size() + backend.getPadding(), '\0');
+	const ParserSource source(buffer.data(), text.size(), buffer.size());
+	const std::size_t count = (std::max)(calibrateBytes / calibrateRounds / text.size(), std::size_t(1));
+
+	backend.parse(source, nullptr);
+	double best = (std::numeric_limits<double>::max)();
+	for(int round = 0; round < calibrateRounds; ++round) {
+		const auto start = std::chrono::steady_clock::now();
+		for(std::size_t i = 0; i < count; ++i) {
+			backend.parse(source, nullptr);
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		best = (std::min)(best, elapsed.count() / count);
+	}
+	return best;
+}
+
+struct CalibrateTiming
+{
+	std::size_t size;
+	double smallTime;
+	double mediumTime;
+	double largeTime;
+};
+
+std::vector<CalibrateTiming> measureShape(
+		const CalibrateShape shape,
+		ParserBackend & smallBackend,
+		ParserBackend & mediumBackend,
+		ParserBackend & largeBackend
+	)
+{
+	std::vector<CalibrateTiming> timingList;
+	for(std::size_t size = calibrateMinSize; size <= calibrateMaxSize; size *= 2) {
+		const std::string text = makeCalibrateDocument(shape, size);
+		timingList.push_back({
+			size,
+			measureBackend(smallBackend, text),
+			measureBackend(mediumBackend, text),
+			measureBackend(largeBackend, text)
+		});
+	}
+	return timingList;
+}
+
+// Returns the size above which `isWinning` is never true, or 0 if it's never true.
+template <typename Predicate>
+std::size_t findCrossover(const std::vector<CalibrateTiming> & timingList, const Predicate & isWinning)
+{
+	for(auto it = timingList.rbegin(); it != timingList.rend(); ++it) {
+		if(isWinning(*it)) {
+			return it->size * 2;
+		}
+	}
+	return 0;
+}
+
+} // namespace
+
+} // namespace internal_
+
+AutoBackendThresholds calibrateAutoBackend(const ParserConfig & config)
+{
+	ParserConfig backendConfig(config);
+	backendConfig.enableComment(false);
+	backendConfig.setReleaseMemorySize(0);
+	std::unique_ptr<ParserBackend> smallBackend = internal_::createBackend_cparser(backendConfig);
+	std::unique_ptr<ParserBackend> mediumBackend = internal_::createBackend_native(backendConfig);
+	std::unique_ptr<ParserBackend> largeBackend = internal_::createBackend_simdjsonDom(backendConfig);
+
+	const std::vector<internal_::CalibrateTiming> denseList = internal_::measureShape(
+		internal_::CalibrateShape::dense, *smallBackend, *mediumBackend, *largeBackend
+	);
+	const std::vector<internal_::CalibrateTiming> sparseList = internal_::measureShape(
+		internal_::CalibrateShape::sparse, *smallBackend, *mediumBackend, *largeBackend
+	);
+
+	AutoBackendThresholds thresholds;
+	thresholds.smallSize = internal_::findCrossover(denseList, [](const internal_::CalibrateTiming & timing) {
+		return timing.smallTime < (std::min)(timing.mediumTime, timing.largeTime);
+	});
+	thresholds.largeSize = internal_::findCrossover(denseList, [](const internal_::CalibrateTiming & timing) {
+		return timing.largeTime >= timing.mediumTime;
+	});
+	thresholds.largeSparseSize = internal_::findCrossover(sparseList, [](const internal_::CalibrateTiming & timing) {
+		return timing.largeTime >= timing.mediumTime;
+	});
+	// The measurements are noisy, a sparse document doesn't need more bytes than a dense one to be faster in simdjson,
+	// and cparser is not used for the documents that simdjson parses faster.
+	thresholds.largeSparseSize = (std::min)(thresholds.largeSparseSize, thresholds.largeSize);
+	thresholds.smallSize = (std::min)(thresholds.smallSize, thresholds.largeSparseSize);
+	return thresholds;
+}
+
+
+} // namespace jsonpp
@@ -37,6 +37,8 @@
 #endif
 
 #include <array>
+#include <cstddef>
+#include <cstring>
 
 namespace jsonpp {
 
@@ -57,6 +59,7 @@ struct CParserImplement
 	static constexpr auto typeString = json_type::json_string;
 	static constexpr auto typeArray = json_type::json_array;
 	static constexpr auto typeObject = json_type::json_object;
+	static constexpr bool knowsContainerSize = true;
 
 	json_type getNodeType(json_value * node) const {
 		return node->type;
@@ -78,8 +81,9 @@ struct CParserImplement
 		return node->u.dbl;
 	}
 
-	std::string getString(json_value * node) const {
-		return std::string(node->u.string.ptr, node->u.string.length);
+	// The view refers to the string in json_value, the string is null terminated.
+	JsonStringView getStringView(json_value * node) const {
+		return JsonStringView(node->u.string.ptr, node->u.string.length);
 	}
 
 	json_value * getArray(json_value * node) const {
@@ -109,7 +113,7 @@ struct CParserImplement
 	void iterateObject(json_value * node, const Callback & callback) const {
 		for(std::size_t i = 0; i < std::size_t(node->u.object.length); ++i) {
 			const auto & objectValue = node->u.object.values[i];
-			callback(objectValue.name, objectValue.value);
+			callback(JsonStringView(objectValue.name, objectValue.name_length), objectValue.value);
 		}
 	}
 
@@ -122,40 +126,240 @@ public:
 	~BackendCParser();
 
 	ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+	ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) override;
+	ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) override;
+	ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) override;
+	ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) override;
+	ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) override;
+	std::size_t getMemorySize() const override;
+	void releaseMemory() override;
+
+private:
+	template <typename Callback>
+	ParserBackendResult doParse(const ParserSource & source, const Callback & callback);
+	template <typename Callback>
+	ParserBackendResult doParse(const char * text, const std::size_t length, const Callback & callback);
 
 private:
 	ParserConfig config;
 
 	json_settings settings;
+	// The tree is allocated from the arena, which is reset before each parse and keeps its memory.
+	std::shared_ptr<MonotonicArena> arena;
+	// The tree of the last parse, it shares the ownership of the arena. It's kept because JsonStringView in the result,
+	// and JsonDocument in zero copy mode, refer to the strings in it.
+	std::shared_ptr<json_value> lastRoot;
 };
 
+// json-parser allocates every value, array and string separately. They are allocated from the arena instead,
+// and freeing them is a no-op, the memory is reclaimed when the arena is reset.
+void * arenaAllocate(size_t size, int zero, void * userData)
+{
+	void * p;
+	try {
+		p = static_cast<MonotonicArena *>(userData)->allocate(size, alignof(std::max_align_t));
+	}
+	catch(const std::bad_alloc &) {
+		// The exception must not pass through json-parser, returning nullptr makes it fail with "Memory allocation failure".
+		return nullptr;
+	}
+	if(zero) {
+		memset(p, 0, size);
+	}
+	return p;
+}
+
+void arenaFree(void * /*p*/, void * /*userData*/)
+{
+}
+
 BackendCParser::BackendCParser(const ParserConfig & config)
-	: config(config), settings()
+	: config(config), settings(), arena(), lastRoot()
 {
 	if(config.allowComment()) {
 		settings.settings |= json_enable_comments;
 	}
+	settings.mem_alloc = &arenaAllocate;
+	settings.mem_free = &arenaFree;
 }
 
 BackendCParser::~BackendCParser()
 {
 }
 
-ParserBackendResult BackendCParser::parse(const ParserSource & source, const metapp::MetaType * prototype)
+template <typename Callback>
+ParserBackendResult BackendCParser::doParse(const ParserSource & source, const Callback & callback)
+{
+	return doParse(source.getText(), source.getTextLength(), callback);
+}
+
+template <typename Callback>
+ParserBackendResult BackendCParser::doParse(const char * text, const std::size_t length, const Callback & callback)
 {
 	std::array<char, json_error_max> error;
 	error[0] = 0;
 
-	json_value * root = json_parse_ex(&settings, source.getText(), source.getTextLength(), error.data());
-	ScopedInvoke scopedInvoke([root]() {
-		if(root != nullptr) {
-			json_value_free(root);
-		}
-	});
+	lastRoot.reset();
+	// A JsonDocument in zero copy mode may still refer to the arena of the previous parse, then the document
+	// keeps that arena and a new one is used.
+	if(! arena || arena.use_count() > 1) {
+		arena = std::make_shared<MonotonicArena>();
+	}
+	else {
+		arena->reset();
+	}
+	settings.user_data = arena.get();
+	json_value * root = json_parse_ex(&settings, text, length, error.data());
+	if(root != nullptr) {
+		lastRoot = std::shared_ptr<json_value>(arena, root);
+	}
 	if(error[0] != 0) {
 		return { metapp::Variant(), error.data() };
 	}
-	return { GeneralParser<CParserImplement>(config, CParserImplement()).parse(root, prototype), std::string() };
+	GeneralParser<CParserImplement> generalParser(config, CParserImplement());
+	return { callback(generalParser, root), std::string() };
+}
+
+ParserBackendResult BackendCParser::parse(const ParserSource & source, const metapp::MetaType * prototype)
+{
+	return doParse(
+		source,
+		[prototype](GeneralParser<CParserImplement> & generalParser, json_value * root) {
+			return generalParser.parse(root, prototype);
+		}
+	);
+}
+
+ParserBackendResult BackendCParser::parseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return doParse(
+		source,
+		[&target](GeneralParser<CParserImplement> & generalParser, json_value * root) {
+			return generalParser.parseInto(root, target);
+		}
+	);
+}
+
+ParserBackendResult BackendCParser::parseDocument(const ParserSource & source, JsonDocument & document)
+{
+	return doParse(
+		source,
+		[this, &document](GeneralParser<CParserImplement> & /*generalParser*/, json_value * root) {
+			if(config.allowZeroCopyString()) {
+				DocumentBuilder<CParserImplement>(document, config).buildZeroCopy(root, lastRoot);
+			}
+			else {
+				DocumentBuilder<CParserImplement>(document, config).build(root);
+			}
+			return metapp::Variant();
+		}
+	);
+}
+
+// json-parser can't parse a stream, so the documents are split and parsed one by one.
+ParserBackendResult BackendCParser::parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	)
+{
+	const char * text = source.getText();
+	ParserBackendResult result { metapp::Variant(), std::string() };
+	splitJsonDocuments(text, source.getTextLength(), config.allowComment(), [this, text, prototype, &callback, &result](
+			const std::size_t begin, const std::size_t end) -> bool {
+		result = doParse(
+			text + begin,
+			end - begin,
+			[prototype](GeneralParser<CParserImplement> & generalParser, json_value * root) {
+				return generalParser.parse(root, prototype);
+			}
+		);
+		if(! result.errorMessage.empty()) {
+			return false;
+		}
+		return callback(result.value);
+	});
+	result.value = metapp::Variant();
+	return result;
+}
+
+// Returns nullptr if the value is not found.
+json_value * findJsonPointer(json_value * root, const std::string & pointer)
+{
+	json_value * node = root;
+	iterateJsonPointer(pointer, [&node](const std::string & token) -> bool {
+		json_value * child = nullptr;
+		if(node->type == json_object) {
+			for(unsigned int i = 0; i < node->u.object.length; ++i) {
+				const auto & objectValue = node->u.object.values[i];
+				if(objectValue.name_length == token.size() && memcmp(objectValue.name, token.data(), token.size()) == 0) {
+					child = objectValue.value;
+					break;
+				}
+			}
+		}
+		else if(node->type == json_array) {
+			std::size_t index;
+			if(getJsonPointerIndex(token, index) && index < node->u.array.length) {
+				child = node->u.array.values[index];
+			}
+		}
+		node = child;
+		return node != nullptr;
+	});
+	return node;
+}
+
+ParserBackendResult BackendCParser::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	)
+{
+	return doParse(
+		source,
+		[&pointers, &prototypes, &results](GeneralParser<CParserImplement> & generalParser, json_value * root) {
+			for(std::size_t i = 0; i < pointers.size(); ++i) {
+				json_value * node = findJsonPointer(root, pointers[i]);
+				if(node != nullptr) {
+					results[i] = generalParser.parse(node, prototypes[i]);
+				}
+			}
+			return metapp::Variant();
+		}
+	);
+}
+
+ParserBackendResult BackendCParser::visit(const ParserSource & source, ParserHandler & handler)
+{
+	return doParse(
+		source,
+		[&handler](GeneralParser<CParserImplement> & /*generalParser*/, json_value * root) {
+			EventWalker<CParserImplement>(handler).walk(root);
+			return metapp::Variant();
+		}
+	);
+}
+
+std::size_t BackendCParser::getMemorySize() const
+{
+	return arena ? arena->getCapacity() : 0;
+}
+
+void BackendCParser::releaseMemory()
+{
+	lastRoot.reset();
+	arena.reset();
 }
 
 std::unique_ptr<ParserBackend> createBackend_cparser(const ParserConfig & config)
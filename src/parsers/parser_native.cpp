@@ -0,0 +1,1401 @@
+// jsonpp library
+//
+// Copyright (C) 2022 Wang Qi (wqking)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/parser.h"
+#include "jsonpp/parserbackend.h"
+
+#if defined(METAPP_COMPILER_VC)
+#pragma warning(push)
+#pragma warning(disable: 4245 4100 4459)
+#endif
+#if defined(METAPP_COMPILER_GCC)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+
+// Only for the exact, locale independent string to double conversion.
+#include "../thirdparty/simdjson/simdjson.h"
+
+#if defined(METAPP_COMPILER_GCC)
+#pragma GCC diagnostic pop
+#endif
+#if defined(METAPP_COMPILER_VC)
+#pragma warning(pop)
+#endif
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSONPP_NATIVE_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace jsonpp {
+
+namespace internal_ {
+
+namespace {
+
+// The bytes scanned at once. The backend requires the same count of padding bytes after the text,
+// so a block that starts before the end of the text can always be loaded.
+constexpr std::size_t nativeBlockSize = 16;
+
+// The same as the default max depth in simdjson.
+constexpr std::size_t nativeMaxDepth = 1024;
+
+class NativeParseError : public std::runtime_error
+{
+public:
+	explicit NativeParseError(const std::string & message) : std::runtime_error(message) {
+	}
+};
+
+inline bool isWhiteSpace(const char c)
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isDigit(const char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// The powers of 10 that are exactly representable in double.
+constexpr double exactPowerOf10List[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+constexpr int maxExactPowerOf10 = 22;
+// The largest integer that all smaller integers are exactly representable in double.
+constexpr uint64_t maxExactDoubleInteger = uint64_t(1) << 53;
+
+#ifdef JSONPP_NATIVE_SSE2
+
+inline int countTrailingZeros(const int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, static_cast<unsigned long>(mask));
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+}
+
+// The bit mask of the bytes in `block` which are '"', '\\', or control characters.
+inline int getStringSpecialMask(const __m128i block)
+{
+	const __m128i control = _mm_set1_epi8(0x1f);
+	const __m128i special = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))),
+		// max(c, 0x1f) == 0x1f if and only if c <= 0x1f as unsigned.
+		_mm_cmpeq_epi8(_mm_max_epu8(block, control), control)
+	);
+	return _mm_movemask_epi8(special);
+}
+
+#endif
+
+// Returns the first '"', '\\', or control character in [p, end), or `end` if there is none.
+inline const char * findStringSpecial(const char * p, const char * end)
+{
+#ifdef JSONPP_NATIVE_SSE2
+	while(p < end) {
+		const int mask = getStringSpecialMask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+		if(mask != 0) {
+			p += countTrailingZeros(mask);
+			return p < end ? p : end;
+		}
+		p += nativeBlockSize;
+	}
+	return end;
+#else
+	while(p < end) {
+		const unsigned char c = static_cast<unsigned char>(*p);
+		if(c == '"' || c == '\\' || c < 0x20) {
+			return p;
+		}
+		++p;
+	}
+	return end;
+#endif
+}
+
+// Copy the string content from `p` to `out` until the first '"', '\\', or control character, or `end`.
+// `p` and `out` are advanced past the copied bytes. Up to nativeBlockSize bytes after the final `out` may be written.
+inline void copyStringRun(const char * & p, char * & out, const char * end)
+{
+#ifdef JSONPP_NATIVE_SSE2
+	while(p < end) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out), block);
+		const int mask = getStringSpecialMask(block);
+		if(mask != 0) {
+			const int count = countTrailingZeros(mask);
+			p += count;
+			out += count;
+			break;
+		}
+		p += nativeBlockSize;
+		out += nativeBlockSize;
+	}
+	if(p > end) {
+		out -= p - end;
+		p = end;
+	}
+#else
+	const char * special = findStringSpecial(p, end);
+	memcpy(out, p, special - p);
+	out += special - p;
+	p = special;
+#endif
+}
+
+// Returns the first '"', '{', '}', '[', ']', or ',' in [p, end), or `end` if there is none.
+inline const char * findStructural(const char * p, const char * end)
+{
+#ifdef JSONPP_NATIVE_SSE2
+	// '[' | 0x20 is '{', and ']' | 0x20 is '}', no other characters map to them.
+	const __m128i caseBit = _mm_set1_epi8(0x20);
+	const __m128i openBrace = _mm_set1_epi8('{');
+	const __m128i closeBrace = _mm_set1_epi8('}');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i quote = _mm_set1_epi8('"');
+	while(p < end) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		const __m128i folded = _mm_or_si128(block, caseBit);
+		const __m128i structural = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, quote))
+		);
+		const int mask = _mm_movemask_epi8(structural);
+		if(mask != 0) {
+			p += countTrailingZeros(mask);
+			return p < end ? p : end;
+		}
+		p += nativeBlockSize;
+	}
+	return end;
+#else
+	while(p < end) {
+		switch(*p) {
+		case '"':
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ',':
+			return p;
+
+		default:
+			break;
+		}
+		++p;
+	}
+	return end;
+#endif
+}
+
+int hexToInt(const char c)
+{
+	if(c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if(c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if(c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+bool readHex4(const char * p, const char * end, uint32_t & result)
+{
+	if(end - p < 4) {
+		return false;
+	}
+	result = 0;
+	for(int i = 0; i < 4; ++i) {
+		const int n = hexToInt(p[i]);
+		if(n < 0) {
+			return false;
+		}
+		result = (result << 4) | static_cast<uint32_t>(n);
+	}
+	return true;
+}
+
+char * writeUtf8(char * out, const uint32_t codePoint)
+{
+	if(codePoint < 0x80) {
+		*out++ = static_cast<char>(codePoint);
+	}
+	else if(codePoint < 0x800) {
+		*out++ = static_cast<char>(0xc0 | (codePoint >> 6));
+		*out++ = static_cast<char>(0x80 | (codePoint & 0x3f));
+	}
+	else if(codePoint < 0x10000) {
+		*out++ = static_cast<char>(0xe0 | (codePoint >> 12));
+		*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+		*out++ = static_cast<char>(0x80 | (codePoint & 0x3f));
+	}
+	else {
+		*out++ = static_cast<char>(0xf0 | (codePoint >> 18));
+		*out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+		*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+		*out++ = static_cast<char>(0x80 | (codePoint & 0x3f));
+	}
+	return out;
+}
+
+} // namespace
+
+enum class NativeNodeType
+{
+	null,
+	boolean,
+	integer,
+	unsignedInteger,
+	real,
+	string,
+	array,
+	object
+};
+
+// An array or object. `index` is the index in the container list built by the structural scan.
+struct NativeContainer
+{
+	const char * p;
+	std::size_t index;
+};
+
+// NativeReader parses the text in two stages.
+// The first stage scans the structural characters, with SIMD if it's available, and records the end and the
+// element count of each array and object, in the order of the opening brackets.
+// The second stage reads the values at the request of GeneralParser, which converts them to Variant directly,
+// no tree is built. A value is "consumed" when it's read, the values that are not read (such as the members
+// not in a class) are skipped. With the container list, skipping an array or object doesn't read its content,
+// so the skipped containers are not fully validated.
+// The strings and keys are unescaped to the string buffer, which is large enough to hold all strings of the document,
+// so the JsonStringView of them are valid until the next parse.
+class NativeReader
+{
+private:
+	struct ContainerInfo
+	{
+		// The offsets of the opening and closing brackets.
+		uint32_t begin;
+		uint32_t end;
+		// The element or member count.
+		uint32_t count;
+		// The index after all nested containers, i.e, the index of the next container after skipping this one.
+		uint32_t next;
+	};
+
+	struct Frame
+	{
+		uint32_t index;
+		uint32_t commaCount;
+		bool empty;
+	};
+
+public:
+	explicit NativeReader(const ParserConfig & config);
+
+	// Scan the text, then the reader is ready to read the values from the beginning.
+	void begin(const char * text_, const std::size_t length);
+
+	// Returns the first value, or fails if the text is empty.
+	const char * getRoot();
+
+	// Prepare to read the values from the beginning again, such as for another JSON Pointer.
+	void rewind();
+
+	const char * skipWhiteSpaces(const char * p) const {
+		while(p < end && isWhiteSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	const char * getEnd() const {
+		return end;
+	}
+
+	const char * getPosition() const {
+		return pos;
+	}
+
+	void setPosition(const char * p) {
+		pos = p;
+	}
+
+	// Skip the value at `p` if it's not consumed. `pos` is after the value.
+	void finishValue(const char * p) {
+		if(pos == p) {
+			skipValue(p);
+		}
+	}
+
+	// Make sure only white spaces follow the value at `p`.
+	void finishRoot(const char * p);
+
+	NativeNodeType getNodeType(const char * p);
+	bool getBoolean(const char * p);
+	int64_t getInteger(const char * p);
+	uint64_t getUnsignedInteger(const char * p);
+	double getDouble(const char * p);
+	JsonStringView getString(const char * p);
+
+	NativeContainer getContainer(const char * p);
+
+	std::size_t getContainerSize(const NativeContainer & container) const {
+		return containerList[container.index].count;
+	}
+
+	template <typename Callback>
+	void iterateArray(const NativeContainer & array, const Callback & callback) {
+		const std::size_t count = getContainerSize(array);
+		std::size_t index = 0;
+		for(const char * p = getFirstItem(array, ']'); p != nullptr; p = getNextItem(array, p, ']')) {
+			if(index >= count) {
+				fail("Invalid array", p);
+			}
+			pos = p;
+			callback(index, p);
+			++index;
+		}
+	}
+
+	template <typename Callback>
+	void iterateObject(const NativeContainer & object, const Callback & callback) {
+		const std::size_t count = getContainerSize(object);
+		std::size_t index = 0;
+		for(const char * p = getFirstItem(object, '}'); p != nullptr; p = getNextItem(object, p, '}')) {
+			if(index >= count) {
+				fail("Invalid object", p);
+			}
+			const JsonStringView key = readKey(p);
+			pos = p;
+			callback(key, p);
+			++index;
+		}
+	}
+
+	// Returns the value of the member, or nullptr if it's not found. The reader stops at the value.
+	const char * findMember(const NativeContainer & object, const JsonStringView & key);
+	// Returns the element at `index`, or nullptr if it's not found. The reader stops at the element.
+	const char * findElement(const NativeContainer & array, const std::size_t index);
+
+	// The string buffer that the strings of the last document refer to, for JsonDocument in zero copy mode.
+	std::shared_ptr<void> getStringBuffer() const {
+		return stringBuffer;
+	}
+
+	std::size_t getMemorySize() const;
+	void releaseMemory();
+
+private:
+	void scan();
+	void skipValue(const char * p);
+	void skipString(const char * p);
+	void parseNumber(const char * p);
+	JsonStringView parseString(const char * p, const char * & after);
+	const char * unescape(const char * p, char * & out);
+	JsonStringView readKey(const char * & p);
+	void allocateStringBuffer(const std::size_t capacity);
+
+	const char * getFirstItem(const NativeContainer & container, const char closer);
+	const char * getNextItem(const NativeContainer & container, const char * item, const char closer);
+
+	char peek(const char * p) const {
+		return p < end ? *p : 0;
+	}
+
+	void fail(const char * message, const char * p) const;
+
+private:
+	std::size_t initialCapacity;
+	std::size_t maxCapacity;
+
+	const char * text;
+	const char * end;
+	// The position after the last consumed value.
+	const char * pos;
+
+	std::vector<ContainerInfo> containerList;
+	std::vector<Frame> frameStack;
+	// The index of the next container to be read in containerList.
+	std::size_t nextContainer;
+
+	std::shared_ptr<char> stringBuffer;
+	std::size_t stringCapacity;
+	char * stringEnd;
+	char * stringLimit;
+	// The full buffers when the strings are read more than once, such as in extract. They are freed by the next parse.
+	std::vector<std::shared_ptr<char> > retiredStringBufferList;
+
+	// The last parsed string. GeneralParser may read the same string twice, such as getting the type and then the value.
+	const char * lastStringPos;
+	const char * lastStringAfter;
+	JsonStringView lastString;
+
+	// The last parsed number, getNodeType parses the number to find its type.
+	const char * numberPos;
+	const char * numberEnd;
+	NativeNodeType numberType;
+	union {
+		int64_t i;
+		uint64_t u;
+		double d;
+	} numberValue;
+};
+
+NativeReader::NativeReader(const ParserConfig & config)
+	:
+		initialCapacity(config.getInitialCapacity()),
+		maxCapacity(config.getMaxCapacity()),
+		text(nullptr),
+		end(nullptr),
+		pos(nullptr),
+		containerList(),
+		frameStack(),
+		nextContainer(0),
+		stringBuffer(),
+		stringCapacity(0),
+		stringEnd(nullptr),
+		stringLimit(nullptr),
+		retiredStringBufferList(),
+		lastStringPos(nullptr),
+		lastStringAfter(nullptr),
+		lastString(),
+		numberPos(nullptr),
+		numberEnd(nullptr),
+		numberType(NativeNodeType::null),
+		numberValue()
+{
+	if(initialCapacity > 0) {
+		allocateStringBuffer(initialCapacity + 1 + nativeBlockSize);
+	}
+}
+
+void NativeReader::begin(const char * text_, const std::size_t length)
+{
+	text = text_;
+	end = text_ + length;
+	if(maxCapacity > 0 && length > maxCapacity) {
+		throw NativeParseError("The document is larger than the max capacity");
+	}
+	// The offsets in ContainerInfo are 32 bits.
+	if(length >= (std::numeric_limits<uint32_t>::max)()) {
+		throw NativeParseError("The document is too large");
+	}
+
+	retiredStringBufferList.clear();
+	// Each string needs at most its length in the text, including the quotes, for the unescaped string and the
+	// null terminator. The extra block is written by copyStringRun.
+	const std::size_t capacity = length + 1 + nativeBlockSize;
+	// A JsonDocument in zero copy mode may still refer to the buffer of the previous parse, then the document keeps it.
+	if(! stringBuffer || stringBuffer.use_count() > 1 || stringCapacity < capacity) {
+		allocateStringBuffer((std::max)(capacity, initialCapacity + 1 + nativeBlockSize));
+	}
+	stringEnd = stringBuffer.get();
+	lastStringPos = nullptr;
+	numberPos = nullptr;
+
+	scan();
+	rewind();
+}
+
+const char * NativeReader::getRoot()
+{
+	const char * root = skipWhiteSpaces(text);
+	if(root >= end) {
+		fail("The document is empty", root);
+	}
+	pos = root;
+	return root;
+}
+
+// The strings read in the previous passes are kept, they may be still referred.
+void NativeReader::rewind()
+{
+	pos = text;
+	nextContainer = 0;
+}
+
+void NativeReader::finishRoot(const char * p)
+{
+	finishValue(p);
+	const char * next = skipWhiteSpaces(pos);
+	if(next < end) {
+		fail("Unexpected content after the document", next);
+	}
+}
+
+void NativeReader::allocateStringBuffer(const std::size_t capacity)
+{
+	stringBuffer.reset(new char[capacity], std::default_delete<char[]>());
+	stringCapacity = capacity;
+	stringEnd = stringBuffer.get();
+	stringLimit = stringEnd + capacity;
+}
+
+// The first stage. The strings are skipped, and the brackets are matched.
+// The other characters, such as numbers and literals, are validated when they are read in the second stage.
+void NativeReader::scan()
+{
+	containerList.clear();
+	frameStack.clear();
+	const char * p = text;
+	for(;;) {
+		p = findStructural(p, end);
+		if(p >= end) {
+			break;
+		}
+		switch(*p) {
+		case '"': {
+			const char * const quote = p;
+			++p;
+			for(;;) {
+				p = findStringSpecial(p, end);
+				if(p >= end) {
+					fail("Unterminated string", quote);
+				}
+				if(*p == '"') {
+					++p;
+					break;
+				}
+				// Skip the escaped character. The control characters are reported when the string is read.
+				p += (*p == '\\' ? 2 : 1);
+			}
+			break;
+		}
+
+		case '[':
+		case '{': {
+			if(frameStack.size() >= nativeMaxDepth) {
+				fail("The document is too deep", p);
+			}
+			const char closer = (*p == '[' ? ']' : '}');
+			const char * next = skipWhiteSpaces(p + 1);
+			frameStack.push_back(Frame {
+				static_cast<uint32_t>(containerList.size()),
+				0,
+				next < end && *next == closer
+			});
+			containerList.push_back(ContainerInfo { static_cast<uint32_t>(p - text), 0, 0, 0 });
+			++p;
+			break;
+		}
+
+		case ']':
+		case '}': {
+			if(frameStack.empty()) {
+				fail("Unexpected closing bracket", p);
+			}
+			const Frame & frame = frameStack.back();
+			ContainerInfo & info = containerList[frame.index];
+			if(text[info.begin] != (*p == ']' ? '[' : '{')) {
+				fail("Mismatched closing bracket", p);
+			}
+			info.end = static_cast<uint32_t>(p - text);
+			info.count = (frame.empty ? 0 : frame.commaCount + 1);
+			info.next = static_cast<uint32_t>(containerList.size());
+			frameStack.pop_back();
+			++p;
+			break;
+		}
+
+		default:
+			// ','
+			if(! frameStack.empty()) {
+				++frameStack.back().commaCount;
+			}
+			++p;
+			break;
+		}
+	}
+	if(! frameStack.empty()) {
+		fail("Unclosed array or object", text + containerList[frameStack.back().index].begin);
+	}
+}
+
+NativeNodeType NativeReader::getNodeType(const char * p)
+{
+	switch(peek(p)) {
+	case '"':
+		return NativeNodeType::string;
+
+	case '[':
+		return NativeNodeType::array;
+
+	case '{':
+		return NativeNodeType::object;
+
+	case 't':
+	case 'f':
+		return NativeNodeType::boolean;
+
+	case 'n':
+		// The literal is validated when the null is skipped.
+		return NativeNodeType::null;
+
+	case '-':
+	case '0':
+	case '1':
+	case '2':
+	case '3':
+	case '4':
+	case '5':
+	case '6':
+	case '7':
+	case '8':
+	case '9':
+		if(numberPos != p) {
+			parseNumber(p);
+		}
+		return numberType;
+
+	default:
+		break;
+	}
+	fail("Invalid value", p);
+	return NativeNodeType::null;
+}
+
+bool NativeReader::getBoolean(const char * p)
+{
+	if(end - p >= 4 && memcmp(p, "true", 4) == 0) {
+		pos = p + 4;
+		return true;
+	}
+	if(end - p >= 5 && memcmp(p, "false", 5) == 0) {
+		pos = p + 5;
+		return false;
+	}
+	fail("Invalid literal", p);
+	return false;
+}
+
+int64_t NativeReader::getInteger(const char * p)
+{
+	if(numberPos != p) {
+		parseNumber(p);
+	}
+	pos = numberEnd;
+	switch(numberType) {
+	case NativeNodeType::integer:
+		return numberValue.i;
+
+	case NativeNodeType::unsignedInteger:
+		return static_cast<int64_t>(numberValue.u);
+
+	default:
+		return static_cast<int64_t>(numberValue.d);
+	}
+}
+
+uint64_t NativeReader::getUnsignedInteger(const char * p)
+{
+	if(numberPos != p) {
+		parseNumber(p);
+	}
+	pos = numberEnd;
+	switch(numberType) {
+	case NativeNodeType::integer:
+		return static_cast<uint64_t>(numberValue.i);
+
+	case NativeNodeType::unsignedInteger:
+		return numberValue.u;
+
+	default:
+		return static_cast<uint64_t>(numberValue.d);
+	}
+}
+
+double NativeReader::getDouble(const char * p)
+{
+	if(numberPos != p) {
+		parseNumber(p);
+	}
+	pos = numberEnd;
+	switch(numberType) {
+	case NativeNodeType::integer:
+		return static_cast<double>(numberValue.i);
+
+	case NativeNodeType::unsignedInteger:
+		return static_cast<double>(numberValue.u);
+
+	default:
+		return numberValue.d;
+	}
+}
+
+JsonStringView NativeReader::getString(const char * p)
+{
+	if(peek(p) != '"') {
+		fail("Expected string", p);
+	}
+	const char * after;
+	const JsonStringView result = parseString(p, after);
+	pos = after;
+	return result;
+}
+
+NativeContainer NativeReader::getContainer(const char * p)
+{
+	// The containers are read in the order of the opening brackets, the skipped ones are passed by ContainerInfo::next.
+	if(nextContainer >= containerList.size() || text + containerList[nextContainer].begin != p) {
+		fail("Invalid array or object", p);
+	}
+	return NativeContainer { p, nextContainer };
+}
+
+const char * NativeReader::getFirstItem(const NativeContainer & container, const char closer)
+{
+	nextContainer = container.index + 1;
+	const char * p = skipWhiteSpaces(container.p + 1);
+	if(peek(p) == closer) {
+		pos = p + 1;
+		return nullptr;
+	}
+	return p;
+}
+
+const char * NativeReader::getNextItem(const NativeContainer & container, const char * item, const char closer)
+{
+	finishValue(item);
+	const char * p = skipWhiteSpaces(pos);
+	const char c = peek(p);
+	if(c == ',') {
+		return skipWhiteSpaces(p + 1);
+	}
+	if(c == closer && p == text + containerList[container.index].end) {
+		pos = p + 1;
+		return nullptr;
+	}
+	fail(closer == ']' ? "Expected ',' or ']'" : "Expected ',' or '}'", p);
+	return nullptr;
+}
+
+JsonStringView NativeReader::readKey(const char * & p)
+{
+	if(peek(p) != '"') {
+		fail("Expected string key", p);
+	}
+	const char * after;
+	const JsonStringView key = parseString(p, after);
+	p = skipWhiteSpaces(after);
+	if(peek(p) != ':') {
+		fail("Expected ':'", p);
+	}
+	p = skipWhiteSpaces(p + 1);
+	return key;
+}
+
+const char * NativeReader::findMember(const NativeContainer & object, const JsonStringView & key)
+{
+	for(const char * p = getFirstItem(object, '}'); p != nullptr; p = getNextItem(object, p, '}')) {
+		const JsonStringView itemKey = readKey(p);
+		pos = p;
+		if(itemKey == key) {
+			return p;
+		}
+	}
+	return nullptr;
+}
+
+const char * NativeReader::findElement(const NativeContainer & array, const std::size_t index)
+{
+	std::size_t i = 0;
+	for(const char * p = getFirstItem(array, ']'); p != nullptr; p = getNextItem(array, p, ']')) {
+		pos = p;
+		if(i == index) {
+			return p;
+		}
+		++i;
+	}
+	return nullptr;
+}
+
+void NativeReader::skipValue(const char * p)
+{
+	switch(peek(p)) {
+	case '"':
+		skipString(p);
+		break;
+
+	case '[':
+	case '{': {
+		const NativeContainer container = getContainer(p);
+		const ContainerInfo & info = containerList[container.index];
+		pos = text + info.end + 1;
+		nextContainer = info.next;
+		break;
+	}
+
+	case 't':
+	case 'f':
+		getBoolean(p);
+		break;
+
+	case 'n':
+		if(end - p >= 4 && memcmp(p, "null", 4) == 0) {
+			pos = p + 4;
+		}
+		else {
+			fail("Invalid literal", p);
+		}
+		break;
+
+	default:
+		// Fails if it's not a number.
+		getNodeType(p);
+		pos = numberEnd;
+		break;
+	}
+}
+
+void NativeReader::skipString(const char * p)
+{
+	const char * s = p + 1;
+	for(;;) {
+		s = findStringSpecial(s, end);
+		if(s >= end) {
+			fail("Unterminated string", p);
+		}
+		if(*s == '"') {
+			break;
+		}
+		if(*s != '\\') {
+			fail("Invalid control character in string", s);
+		}
+		s += 2;
+	}
+	pos = s + 1;
+}
+
+// Validate against the JSON number grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// The digits are accumulated while they are validated. If the number is an integer, or its significand and exponent
+// are small enough, the value is computed exactly without another pass (Clinger's fast path), otherwise it's converted
+// by simdjson::internal::from_chars. Both are independent of the C locale and don't allocate.
+void NativeReader::parseNumber(const char * p)
+{
+	const char * s = p;
+	const bool negative = (peek(s) == '-');
+	if(negative) {
+		++s;
+	}
+	const char * digits = s;
+	uint64_t n = 0;
+	bool overflow = false;
+	while(s < end && isDigit(*s)) {
+		const uint64_t digit = static_cast<uint64_t>(*s - '0');
+		if(n > ((std::numeric_limits<uint64_t>::max)() - digit) / 10) {
+			overflow = true;
+		}
+		else {
+			n = n * 10 + digit;
+		}
+		++s;
+	}
+	const std::size_t digitCount = s - digits;
+	if(digitCount == 0 || (digits[0] == '0' && digitCount > 1)) {
+		fail("Invalid number", p);
+	}
+	bool isInteger = true;
+	// The significand is `n` with the fraction digits appended, the value is `n * 10^exponent`.
+	int exponent = 0;
+	if(peek(s) == '.') {
+		isInteger = false;
+		++s;
+		const char * fraction = s;
+		while(s < end && isDigit(*s)) {
+			if(! overflow && n < maxExactDoubleInteger) {
+				n = n * 10 + static_cast<uint64_t>(*s - '0');
+				--exponent;
+			}
+			else if(*s != '0') {
+				// The significand is not exact, let from_chars handle it.
+				overflow = true;
+			}
+			++s;
+		}
+		if(s == fraction) {
+			fail("Invalid number", p);
+		}
+	}
+	const char e = peek(s);
+	if(e == 'e' || e == 'E') {
+		isInteger = false;
+		++s;
+		const char sign = peek(s);
+		if(sign == '+' || sign == '-') {
+			++s;
+		}
+		const char * exponentDigits = s;
+		int explicitExponent = 0;
+		while(s < end && isDigit(*s)) {
+			if(explicitExponent < 100000) {
+				explicitExponent = explicitExponent * 10 + (*s - '0');
+			}
+			++s;
+		}
+		if(s == exponentDigits) {
+			fail("Invalid number", p);
+		}
+		exponent += (sign == '-' ? -explicitExponent : explicitExponent);
+	}
+
+	numberPos = p;
+	numberEnd = s;
+	if(isInteger && ! overflow) {
+		const uint64_t maxInt = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
+		if(negative && n <= maxInt + 1) {
+			numberType = NativeNodeType::integer;
+			numberValue.i = (n == maxInt + 1 ? (std::numeric_limits<int64_t>::min)() : -static_cast<int64_t>(n));
+			return;
+		}
+		if(! negative) {
+			if(n <= maxInt) {
+				numberType = NativeNodeType::integer;
+				numberValue.i = static_cast<int64_t>(n);
+			}
+			else {
+				numberType = NativeNodeType::unsignedInteger;
+				numberValue.u = n;
+			}
+			return;
+		}
+	}
+	numberType = NativeNodeType::real;
+	if(! overflow && n <= maxExactDoubleInteger && exponent >= -maxExactPowerOf10 && exponent <= maxExactPowerOf10) {
+		double value = static_cast<double>(n);
+		if(exponent < 0) {
+			value /= exactPowerOf10List[-exponent];
+		}
+		else {
+			value *= exactPowerOf10List[exponent];
+		}
+		numberValue.d = (negative ? -value : value);
+		return;
+	}
+	numberValue.d = simdjson::internal::from_chars(p, s);
+	if(std::isinf(numberValue.d)) {
+		fail("Number out of range", p);
+	}
+}
+
+JsonStringView NativeReader::parseString(const char * p, const char * & after)
+{
+	if(p == lastStringPos) {
+		after = lastStringAfter;
+		return lastString;
+	}
+	// The unescaped string is not longer than the remaining text. If the buffer is short, the string was read
+	// before in another pass, the buffer is retired and a new one is used.
+	if(static_cast<std::size_t>(stringLimit - stringEnd) < static_cast<std::size_t>(end - p) + 1 + nativeBlockSize) {
+		retiredStringBufferList.push_back(stringBuffer);
+		allocateStringBuffer(stringCapacity);
+	}
+	char * const begin = stringEnd;
+	char * out = begin;
+	const char * s = p + 1;
+	for(;;) {
+		copyStringRun(s, out, end);
+		if(s >= end) {
+			fail("Unterminated string", p);
+		}
+		if(*s == '"') {
+			break;
+		}
+		if(*s != '\\') {
+			fail("Invalid control character in string", s);
+		}
+		s = unescape(s + 1, out);
+	}
+	*out = 0;
+	stringEnd = out + 1;
+	after = s + 1;
+	lastStringPos = p;
+	lastStringAfter = after;
+	lastString = JsonStringView(begin, out - begin);
+	return lastString;
+}
+
+// `p` is after the backslash. Returns the position after the escape sequence.
+const char * NativeReader::unescape(const char * p, char * & out)
+{
+	const char c = peek(p);
+	switch(c) {
+	case '"': *out++ = '"'; return p + 1;
+	case '\\': *out++ = '\\'; return p + 1;
+	case '/': *out++ = '/'; return p + 1;
+	case 'b': *out++ = '\b'; return p + 1;
+	case 'f': *out++ = '\f'; return p + 1;
+	case 'n': *out++ = '\n'; return p + 1;
+	case 'r': *out++ = '\r'; return p + 1;
+	case 't': *out++ = '\t'; return p + 1;
+
+	case 'u': {
+		uint32_t codePoint;
+		if(! readHex4(p + 1, end, codePoint)) {
+			fail("Invalid unicode escape in string", p);
+		}
+		p += 5;
+		if(codePoint >= 0xd800 && codePoint <= 0xdbff) {
+			uint32_t low;
+			if(end - p < 2 || p[0] != '\\' || p[1] != 'u' || ! readHex4(p + 2, end, low) || low < 0xdc00 || low > 0xdfff) {
+				fail("Invalid unicode surrogate pair in string", p);
+			}
+			p += 6;
+			codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+		}
+		else if(codePoint >= 0xdc00 && codePoint <= 0xdfff) {
+			fail("Invalid unicode surrogate pair in string", p);
+		}
+		out = writeUtf8(out, codePoint);
+		return p;
+	}
+
+	default:
+		break;
+	}
+	fail("Invalid escape character in string", p);
+	return p;
+}
+
+void NativeReader::fail(const char * message, const char * p) const
+{
+	throw NativeParseError(std::string(message) + " at offset " + std::to_string(p - text));
+}
+
+std::size_t NativeReader::getMemorySize() const
+{
+	return stringCapacity * (1 + retiredStringBufferList.size())
+		+ containerList.capacity() * sizeof(ContainerInfo)
+		+ frameStack.capacity() * sizeof(Frame)
+	;
+}
+
+void NativeReader::releaseMemory()
+{
+	retiredStringBufferList.clear();
+	stringBuffer.reset();
+	stringCapacity = 0;
+	stringEnd = nullptr;
+	stringLimit = nullptr;
+	std::vector<ContainerInfo>().swap(containerList);
+	std::vector<Frame>().swap(frameStack);
+	if(initialCapacity > 0) {
+		allocateStringBuffer(initialCapacity + 1 + nativeBlockSize);
+	}
+}
+
+// The node is the position of the value in the text.
+struct NativeImplement
+{
+	using ArrayValue = const char *;
+	using ObjectValue = const char *;
+	using Array = NativeContainer;
+	using Object = NativeContainer;
+
+	static constexpr NativeNodeType typeNull = NativeNodeType::null;
+	static constexpr NativeNodeType typeBoolean = NativeNodeType::boolean;
+	static constexpr NativeNodeType typeInteger = NativeNodeType::integer;
+	static constexpr NativeNodeType typeUnsignedInteger = NativeNodeType::unsignedInteger;
+	static constexpr NativeNodeType typeDouble = NativeNodeType::real;
+	static constexpr NativeNodeType typeString = NativeNodeType::string;
+	static constexpr NativeNodeType typeArray = NativeNodeType::array;
+	static constexpr NativeNodeType typeObject = NativeNodeType::object;
+	static constexpr bool knowsContainerSize = true;
+
+	explicit NativeImplement(NativeReader * reader) : reader(reader) {
+	}
+
+	NativeNodeType getNodeType(const char * node) const {
+		return reader->getNodeType(node);
+	}
+
+	bool getBoolean(const char * node) const {
+		return reader->getBoolean(node);
+	}
+
+	int64_t getInteger(const char * node) const {
+		return reader->getInteger(node);
+	}
+
+	uint64_t getUnsignedInteger(const char * node) const {
+		return reader->getUnsignedInteger(node);
+	}
+
+	double getDouble(const char * node) const {
+		return reader->getDouble(node);
+	}
+
+	// The view refers to the string buffer in the reader, the string is null terminated.
+	JsonStringView getStringView(const char * node) const {
+		return reader->getString(node);
+	}
+
+	NativeContainer getArray(const char * node) const {
+		return reader->getContainer(node);
+	}
+
+	NativeContainer getObject(const char * node) const {
+		return reader->getContainer(node);
+	}
+
+	std::size_t getArraySize(const NativeContainer & node) const {
+		return reader->getContainerSize(node);
+	}
+
+	template <typename Callback>
+	void iterateArray(const NativeContainer & node, const Callback & callback) const {
+		reader->iterateArray(node, callback);
+	}
+
+	std::size_t getObjectSize(const NativeContainer & node) const {
+		return reader->getContainerSize(node);
+	}
+
+	template <typename Callback>
+	void iterateObject(const NativeContainer & node, const Callback & callback) const {
+		reader->iterateObject(node, callback);
+	}
+
+	NativeReader * reader;
+};
+
+class BackendNative : public ParserBackend
+{
+public:
+	explicit BackendNative(const ParserConfig & config);
+	~BackendNative();
+
+	ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+	ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) override;
+	ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) override;
+	ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) override;
+	ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) override;
+	ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) override;
+	std::size_t getMemorySize() const override;
+	void releaseMemory() override;
+
+	std::size_t getPadding() const override {
+		return nativeBlockSize;
+	}
+
+private:
+	template <typename Callback>
+	ParserBackendResult doParse(const ParserSource & source, const Callback & callback);
+
+	const char * findJsonPointer(const char * root, const std::string & pointer);
+
+private:
+	ParserConfig config;
+	NativeReader reader;
+};
+
+BackendNative::BackendNative(const ParserConfig & config)
+	: config(config), reader(config)
+{
+}
+
+BackendNative::~BackendNative()
+{
+}
+
+template <typename Callback>
+ParserBackendResult BackendNative::doParse(const ParserSource & source, const Callback & callback)
+{
+	try {
+		reader.begin(source.getText(), source.getTextLength());
+		const char * root = reader.getRoot();
+		GeneralParser<NativeImplement> generalParser(config, NativeImplement(&reader));
+		metapp::Variant result = callback(generalParser, root);
+		reader.finishRoot(root);
+		return { std::move(result), std::string() };
+	}
+	catch(const NativeParseError & e) {
+		return { metapp::Variant(), e.what() };
+	}
+}
+
+ParserBackendResult BackendNative::parse(const ParserSource & source, const metapp::MetaType * prototype)
+{
+	return doParse(
+		source,
+		[prototype](GeneralParser<NativeImplement> & generalParser, const char * root) {
+			return generalParser.parse(root, prototype);
+		}
+	);
+}
+
+ParserBackendResult BackendNative::parseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return doParse(
+		source,
+		[&target](GeneralParser<NativeImplement> & generalParser, const char * root) {
+			return generalParser.parseInto(root, target);
+		}
+	);
+}
+
+ParserBackendResult BackendNative::parseDocument(const ParserSource & source, JsonDocument & document)
+{
+	return doParse(
+		source,
+		[this, &document](GeneralParser<NativeImplement> & /*generalParser*/, const char * root) {
+			DocumentBuilder<NativeImplement> builder(document, config, NativeImplement(&reader));
+			if(config.allowZeroCopyString()) {
+				// The document keeps the string buffer, the next parse uses a new buffer.
+				builder.buildZeroCopy(root, reader.getStringBuffer());
+			}
+			else {
+				builder.build(root);
+			}
+			return metapp::Variant();
+		}
+	);
+}
+
+// The whole stream is scanned once, then the documents are read one by one.
+ParserBackendResult BackendNative::parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	)
+{
+	try {
+		reader.begin(source.getText(), source.getTextLength());
+		GeneralParser<NativeImplement> generalParser(config, NativeImplement(&reader));
+		for(const char * p = reader.skipWhiteSpaces(source.getText()); p < reader.getEnd(); p = reader.skipWhiteSpaces(reader.getPosition())) {
+			reader.setPosition(p);
+			const metapp::Variant value = generalParser.parse(p, prototype);
+			reader.finishValue(p);
+			if(! callback(value)) {
+				break;
+			}
+		}
+		return { metapp::Variant(), std::string() };
+	}
+	catch(const NativeParseError & e) {
+		return { metapp::Variant(), e.what() };
+	}
+}
+
+// Returns nullptr if the value is not found. The values before the found value are skipped without being parsed.
+const char * BackendNative::findJsonPointer(const char * root, const std::string & pointer)
+{
+	const char * node = root;
+	iterateJsonPointer(pointer, [this, &node](const std::string & token) -> bool {
+		const char * child = nullptr;
+		const NativeNodeType nodeType = reader.getNodeType(node);
+		if(nodeType == NativeNodeType::object) {
+			child = reader.findMember(reader.getContainer(node), JsonStringView(token));
+		}
+		else if(nodeType == NativeNodeType::array) {
+			std::size_t index;
+			if(getJsonPointerIndex(token, index)) {
+				child = reader.findElement(reader.getContainer(node), index);
+			}
+		}
+		node = child;
+		return node != nullptr;
+	});
+	return node;
+}
+
+ParserBackendResult BackendNative::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	)
+{
+	try {
+		reader.begin(source.getText(), source.getTextLength());
+		const char * root = reader.getRoot();
+		reader.finishRoot(root);
+		GeneralParser<NativeImplement> generalParser(config, NativeImplement(&reader));
+		for(std::size_t i = 0; i < pointers.size(); ++i) {
+			reader.rewind();
+			const char * node = findJsonPointer(root, pointers[i]);
+			if(node != nullptr) {
+				reader.setPosition(node);
+				results[i] = generalParser.parse(node, prototypes[i]);
+			}
+		}
+		return { metapp::Variant(), std::string() };
+	}
+	catch(const NativeParseError & e) {
+		return { metapp::Variant(), e.what() };
+	}
+}
+
+ParserBackendResult BackendNative::visit(const ParserSource & source, ParserHandler & handler)
+{
+	return doParse(
+		source,
+		[this, &handler](GeneralParser<NativeImplement> & /*generalParser*/, const char * root) {
+			EventWalker<NativeImplement>(handler, NativeImplement(&reader)).walk(root);
+			return metapp::Variant();
+		}
+	);
+}
+
+std::size_t BackendNative::getMemorySize() const
+{
+	return reader.getMemorySize();
+}
+
+void BackendNative::releaseMemory()
+{
+	reader.releaseMemory();
+}
+
+std::unique_ptr<ParserBackend> createBackend_native(const ParserConfig & config)
+{
+	return std::unique_ptr<ParserBackend>(new BackendNative(config));
+}
+
+
+} // namespace internal_
+
+} // namespace jsonpp
@@ -37,16 +37,48 @@
 #endif
 
 #include <array>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace jsonpp {
 
 namespace internal_ {
 
+std::size_t getSimdjsonMaxCapacity(const ParserConfig & config)
+{
+	if(config.getMaxCapacity() == 0) {
+		return simdjson::SIMDJSON_MAXSIZE_BYTES;
+	}
+	return config.getMaxCapacity();
+}
+
+// Advise the kernel to back the memory with transparent huge pages. Only the whole pages in the range are advised.
+void adviseHugePages(const void * address, const std::size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	const std::uintptr_t pageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+	const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(address) + pageSize - 1) & ~(pageSize - 1);
+	const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(address) + size) & ~(pageSize - 1);
+	if(begin < end) {
+		madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+	}
+#else
+	(void)address;
+	(void)size;
+#endif
+}
+
+static_assert(ParserSource::filePadding >= simdjson::SIMDJSON_PADDING, "ParserSource::filePadding must cover simdjson padding");
+
 class BackendSimdjson : public ParserBackend
 {
 public:
-	void prepareSource(const ParserSource & source) const override {
-		source.pad(simdjson::SIMDJSON_PADDING);
+	std::size_t getPadding() const override {
+		return simdjson::SIMDJSON_PADDING;
 	}
 
 };
@@ -57,6 +89,28 @@ public:
 	~BackendSimdjsonDom();
 
 	ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+	ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) override;
+	ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) override;
+	ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) override;
+	ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) override;
+	ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) override;
+	std::size_t getMemorySize() const override;
+	void releaseMemory() override;
+
+private:
+	template <typename Callback>
+	ParserBackendResult doParse(const ParserSource & source, const Callback & callback);
+
+	void reserve(std::size_t capacity);
 
 private:
 	ParserConfig config;
@@ -64,8 +118,34 @@ private:
 };
 
 BackendSimdjsonDom::BackendSimdjsonDom(const ParserConfig & config)
-	: config(config), parser()
+	: config(config), parser(getSimdjsonMaxCapacity(config))
+{
+	if(config.getInitialCapacity() > 0) {
+		reserve(config.getInitialCapacity());
+	}
+}
+
+// Allocate the buffers of both the parser and its document, so parsing the documents up to `capacity` doesn't allocate.
+// If it fails, the error is reported by the next parse.
+void BackendSimdjsonDom::reserve(std::size_t capacity)
 {
+	capacity = (std::max)(capacity, simdjson::dom::MINIMAL_DOCUMENT_CAPACITY);
+	if(capacity > parser.max_capacity()) {
+		return;
+	}
+	if(parser.allocate(capacity) != simdjson::SUCCESS || parser.doc.allocate(capacity) != simdjson::SUCCESS) {
+		return;
+	}
+	if(config.allowHugePages()) {
+		// The buffers are advised before they are touched. The sizes are the same as in simdjson
+		// document::allocate and dom_parser_implementation::set_capacity.
+		adviseHugePages(parser.doc.tape.get(), SIMDJSON_ROUNDUP_N(capacity + 3, 64) * sizeof(uint64_t));
+		adviseHugePages(parser.doc.string_buf.get(), SIMDJSON_ROUNDUP_N(5 * capacity / 3 + simdjson::SIMDJSON_PADDING, 64));
+		adviseHugePages(
+			parser.implementation->structural_indexes.get(),
+			(SIMDJSON_ROUNDUP_N(capacity, 64) + 2 + 7) * sizeof(uint32_t)
+		);
+	}
 }
 
 BackendSimdjsonDom::~BackendSimdjsonDom()
@@ -87,6 +167,7 @@ struct SimdjsonDomImplement
 	static constexpr auto typeString = simdjson::dom::element_type::STRING;
 	static constexpr auto typeArray = simdjson::dom::element_type::ARRAY;
 	static constexpr auto typeObject = simdjson::dom::element_type::OBJECT;
+	static constexpr bool knowsContainerSize = true;
 
 	simdjson::dom::element_type getNodeType(const simdjson::dom::element & node) const {
 		return node.type();
@@ -108,8 +189,9 @@ struct SimdjsonDomImplement
 		return node.get<double>();
 	}
 
-	std::string getString(const simdjson::dom::element & node) const {
-		return node.get<const char *>().value();
+	// The view refers to the string buffer in the simdjson document, the string is null terminated.
+	JsonStringView getStringView(const simdjson::dom::element & node) const {
+		return JsonStringView(node.get_c_str().value(), node.get_string_length().value());
 	}
 
 	simdjson::dom::array getArray(const simdjson::dom::element & node) const {
@@ -140,20 +222,164 @@ struct SimdjsonDomImplement
 	template <typename Callback>
 	void iterateObject(const simdjson::dom::object & node, const Callback & callback) const {
 		for(auto it = node.begin(); it != node.end(); ++it) {
-			callback(it.key_c_str(), it.value());
+			callback(JsonStringView(it.key_c_str(), it.key_length()), it.value());
 		}
 	}
 
 };
 
-ParserBackendResult BackendSimdjsonDom::parse(const ParserSource & source, const metapp::MetaType * prototype)
+template <typename Callback>
+ParserBackendResult BackendSimdjsonDom::doParse(const ParserSource & source, const Callback & callback)
 {
+	// Let simdjson grow the buffers, unless they need to be advised before being touched.
+	if(config.allowHugePages() && source.getTextLength() > parser.capacity()) {
+		reserve(source.getTextLength());
+	}
 	simdjson::dom::element element;
 	auto r = parser.parse(source.getText(), source.getTextLength(), false).get(element);
 	if(r != simdjson::SUCCESS) {
 		return { metapp::Variant(), simdjson::error_message(r) };
 	}
-	return { GeneralParser<SimdjsonDomImplement>(config, SimdjsonDomImplement()).parse(element, prototype), std::string() };
+	GeneralParser<SimdjsonDomImplement> generalParser(config, SimdjsonDomImplement());
+	return { callback(generalParser, element), std::string() };
+}
+
+ParserBackendResult BackendSimdjsonDom::parse(const ParserSource & source, const metapp::MetaType * prototype)
+{
+	return doParse(
+		source,
+		[prototype](GeneralParser<SimdjsonDomImplement> & generalParser, const simdjson::dom::element & element) {
+			return generalParser.parse(element, prototype);
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonDom::parseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return doParse(
+		source,
+		[&target](GeneralParser<SimdjsonDomImplement> & generalParser, const simdjson::dom::element & element) {
+			return generalParser.parseInto(element, target);
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonDom::parseDocument(const ParserSource & source, JsonDocument & document)
+{
+	if(config.allowZeroCopyString()) {
+		// Parse into a simdjson document owned by `document`, so the strings stay valid after the parser is reused.
+		std::shared_ptr<simdjson::dom::document> domDocument = std::make_shared<simdjson::dom::document>();
+		simdjson::dom::element element;
+		auto r = parser.parse_into_document(*domDocument, source.getText(), source.getTextLength(), false).get(element);
+		if(r != simdjson::SUCCESS) {
+			return { metapp::Variant(), simdjson::error_message(r) };
+		}
+		DocumentBuilder<SimdjsonDomImplement>(document, config).buildZeroCopy(element, domDocument);
+		return { metapp::Variant(), std::string() };
+	}
+	return doParse(
+		source,
+		[this, &document](GeneralParser<SimdjsonDomImplement> & /*generalParser*/, const simdjson::dom::element & element) {
+			DocumentBuilder<SimdjsonDomImplement>(document, config).build(element);
+			return metapp::Variant();
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonDom::parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	)
+{
+	if(skipJsonWhiteSpaces(source.getText(), source.getTextLength(), 0) == source.getTextLength()) {
+		return { metapp::Variant(), std::string() };
+	}
+	simdjson::dom::document_stream stream;
+	auto r = parser.parse_many(source.getText(), source.getTextLength(), config.getBatchSize()).get(stream);
+	if(r != simdjson::SUCCESS) {
+		return { metapp::Variant(), simdjson::error_message(r) };
+	}
+	GeneralParser<SimdjsonDomImplement> generalParser(config, SimdjsonDomImplement());
+	for(auto it = stream.begin(); it != stream.end(); ++it) {
+		simdjson::dom::element element;
+		r = (*it).get(element);
+		if(r != simdjson::SUCCESS) {
+			return { metapp::Variant(), simdjson::error_message(r) };
+		}
+		if(! callback(generalParser.parse(element, prototype))) {
+			return { metapp::Variant(), std::string() };
+		}
+	}
+	// parse_many silently ignores the incomplete document at the end.
+	if(stream.truncated_bytes() != 0) {
+		return { metapp::Variant(), "Incomplete JSON document at the end of the stream." };
+	}
+	return { metapp::Variant(), std::string() };
+}
+
+// These errors mean the pointer doesn't match the document, the value is not found.
+inline bool isPointerNotFound(const simdjson::error_code error)
+{
+	return error == simdjson::NO_SUCH_FIELD
+		|| error == simdjson::INDEX_OUT_OF_BOUNDS
+		|| error == simdjson::INCORRECT_TYPE
+		|| error == simdjson::INVALID_JSON_POINTER
+	;
+}
+
+// dom::element::at_pointer skips the unmatched values using the jump offsets in the tape,
+// only the matched values are converted.
+ParserBackendResult BackendSimdjsonDom::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	)
+{
+	return doParse(
+		source,
+		[&pointers, &prototypes, &results](GeneralParser<SimdjsonDomImplement> & generalParser, const simdjson::dom::element & root) {
+			for(std::size_t i = 0; i < pointers.size(); ++i) {
+				simdjson::dom::element element;
+				const auto r = root.at_pointer(std::string_view(pointers[i].data(), pointers[i].size())).get(element);
+				if(r == simdjson::SUCCESS) {
+					results[i] = generalParser.parse(element, prototypes[i]);
+				}
+				else if(! isPointerNotFound(r)) {
+					throw simdjson::simdjson_error(r);
+				}
+			}
+			return metapp::Variant();
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonDom::visit(const ParserSource & source, ParserHandler & handler)
+{
+	return doParse(
+		source,
+		[&handler](GeneralParser<SimdjsonDomImplement> & /*generalParser*/, const simdjson::dom::element & element) {
+			EventWalker<SimdjsonDomImplement>(handler).walk(element);
+			return metapp::Variant();
+		}
+	);
+}
+
+// The document holds the tape (8 bytes per structural) and the string buffer, the implementation holds
+// the structural indexes (4 bytes per byte of capacity).
+std::size_t BackendSimdjsonDom::getMemorySize() const
+{
+	const std::size_t capacity = parser.capacity();
+	return capacity * 8 + capacity * 5 / 3 + capacity * 4;
+}
+
+void BackendSimdjsonDom::releaseMemory()
+{
+	parser = simdjson::dom::parser(getSimdjsonMaxCapacity(config));
+	if(config.getInitialCapacity() > 0) {
+		reserve(config.getInitialCapacity());
+	}
 }
 
 std::unique_ptr<ParserBackend> createBackend_simdjsonDom(const ParserConfig & config)
@@ -161,13 +387,12 @@ std::unique_ptr<ParserBackend> createBackend_simdjsonDom(const ParserConfig & co
 	return std::unique_ptr<ParserBackend>(new BackendSimdjsonDom(config));
 }
 
-#if 0
 /*
-Dropped support for simdjson::ondemand, because,
-1, it doesn't gain much performance than simdjson::dom for jsonpp.
-2, it doesn't treat "5, 6" as error.
-3, it throws error on "true", while the node has boolean type but get_bool doesn't agree.
-No need to waste time on it.
+simdjson::ondemand only touches the values that are actually requested.
+When parsing with a prototype, any object field that the prototype doesn't have is skipped by the object iterator
+without being converted, so parsing a large document into a small class is much faster than simdjson::dom.
+When parsing without prototype, all values are requested, and the performance is similar to simdjson::dom.
+Note: ondemand doesn't validate the values it skips, and the document must be fully consumed to detect trailing content.
 */
 class BackendSimdjsonOnDemand : public BackendSimdjson
 {
@@ -175,50 +400,54 @@ public:
 	explicit BackendSimdjsonOnDemand(const ParserConfig & config);
 	~BackendSimdjsonOnDemand();
 
-	bool hasError() const override;
-	std::string getError() const override;
+	ParserBackendResult parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+	ParserBackendResult parseInto(const ParserSource & source, const metapp::Variant & target) override;
+	ParserBackendResult parseDocument(const ParserSource & source, JsonDocument & document) override;
+	ParserBackendResult parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	) override;
+	ParserBackendResult extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	) override;
+	ParserBackendResult visit(const ParserSource & source, ParserHandler & handler) override;
+	std::size_t getMemorySize() const override;
+	void releaseMemory() override;
 
-	metapp::Variant parse(const ParserSource & source, const metapp::MetaType * prototype) override;
+private:
+	template <typename Callback>
+	ParserBackendResult doParse(const ParserSource & source, const Callback & callback);
+	template <typename Callback>
+	ParserBackendResult doParse(const char * text, const std::size_t length, const std::size_t capacity, const Callback & callback);
+
+	void reserve();
 
 private:
 	ParserConfig config;
 	simdjson::ondemand::parser parser;
-
-	std::string errorString;
 };
 
 BackendSimdjsonOnDemand::BackendSimdjsonOnDemand(const ParserConfig & config)
-	: config(config), parser()
+	: config(config), parser(getSimdjsonMaxCapacity(config))
 {
+	reserve();
 }
 
-BackendSimdjsonOnDemand::~BackendSimdjsonOnDemand()
+// The buffers of ondemand are private in simdjson, they can't be advised to use huge pages.
+// If it fails, the error is reported by the next parse.
+void BackendSimdjsonOnDemand::reserve()
 {
+	if(config.getInitialCapacity() > 0) {
+		(void)parser.allocate((std::min)(config.getInitialCapacity(), parser.max_capacity()));
+	}
 }
 
-bool BackendSimdjsonOnDemand::hasError() const
-{
-	return ! errorString.empty();
-}
-
-std::string BackendSimdjsonOnDemand::getError() const
-{
-	return errorString;
-}
-
-simdjson::ondemand::value getValue(simdjson::ondemand::document && v) {
-	return v.get_value();
-}
-
-simdjson::ondemand::value getValue(simdjson::ondemand::value v) {
-	return v;
-}
-
-template <typename T>
-std::string toString(T && s)
+BackendSimdjsonOnDemand::~BackendSimdjsonOnDemand()
 {
-	auto view = s.value();
-	return std::string(view.data(), view.size());
 }
 
 struct SimdjsonOnDemandImplement
@@ -228,107 +457,260 @@ struct SimdjsonOnDemandImplement
 	using Array = simdjson::ondemand::array;
 	using Object = simdjson::ondemand::object;
 
+	// ondemand reports all numbers as json_type::number, we use number_type to distinguish them.
+	static constexpr int numberTypeBase = 1000;
+
 	static constexpr int typeNull = (int)simdjson::ondemand::json_type::null;
 	static constexpr int typeBoolean = (int)simdjson::ondemand::json_type::boolean;
-	static constexpr int typeInteger = (int)simdjson::ondemand::number_type::signed_integer + 1000;
-	static constexpr int typeUnsignedInteger = (int)simdjson::ondemand::number_type::unsigned_integer + 1000;
-	static constexpr int typeDouble = (int)simdjson::ondemand::number_type::floating_point_number + 1000;
+	static constexpr int typeInteger = (int)simdjson::ondemand::number_type::signed_integer + numberTypeBase;
+	static constexpr int typeUnsignedInteger = (int)simdjson::ondemand::number_type::unsigned_integer + numberTypeBase;
+	static constexpr int typeDouble = (int)simdjson::ondemand::number_type::floating_point_number + numberTypeBase;
 	static constexpr int typeString = (int)simdjson::ondemand::json_type::string;
 	static constexpr int typeArray = (int)simdjson::ondemand::json_type::array;
 	static constexpr int typeObject = (int)simdjson::ondemand::json_type::object;
+	// The sizes are counted by scanning the containers, so GeneralParser and DocumentBuilder append while iterating.
+	static constexpr bool knowsContainerSize = false;
 
+	// T is either simdjson::ondemand::document & (the root), or simdjson::ondemand::value
 	template <typename T>
 	int getNodeType(T && node) const {
-		auto type = node.type().value();
+		const auto type = node.type().value();
 		if(type == simdjson::ondemand::json_type::number) {
-			return (int)node.get_number_type().value() + 1000;
+			return (int)node.get_number_type().value() + numberTypeBase;
+		}
+		if(type == simdjson::ondemand::json_type::null) {
+			// null is never requested by GeneralParser, consume it here so a null root is fully consumed,
+			// and "nul" is reported as error.
+			if(! node.is_null()) {
+				throw simdjson::simdjson_error(simdjson::N_ATOM_ERROR);
+			}
 		}
 		return (int)type;
 	}
 
 	template <typename T>
 	bool getBoolean(T && node) const {
-		return node.get_bool();
+		return node.get_bool().value();
 	}
 
 	template <typename T>
 	int64_t getInteger(T && node) const {
-		return node.get_int64();
+		return node.get_int64().value();
 	}
 
 	template <typename T>
 	uint64_t getUnsignedInteger(T && node) const {
-		return node.get_uint64();
+		return node.get_uint64().value();
 	}
 
 	template <typename T>
 	double getDouble(T && node) const {
-		return node.get_double();
+		return node.get_double().value();
 	}
 
+	// The view refers to the string buffer in the parser, it's not null terminated.
 	template <typename T>
-	std::string getString(T && node) const {
-		return toString(node.get_string());
+	JsonStringView getStringView(T && node) const {
+		const std::string_view view = node.get_string().value();
+		return JsonStringView(view.data(), view.size());
 	}
 
 	template <typename T>
 	simdjson::ondemand::array getArray(T && node) const {
-		return node.get_array();
+		return node.get_array().value();
 	}
 
 	template <typename T>
 	simdjson::ondemand::object getObject(T && node) const {
-		return node.get_object();
+		return node.get_object().value();
 	}
 
-	std::size_t getArraySize(simdjson::ondemand::array node) const {
-		return node.count_elements();
+	// Scans the array, it's only used where the size is required before the elements, such as Parser::visit.
+	std::size_t getArraySize(simdjson::ondemand::array & node) const {
+		return node.count_elements().value();
 	}
 
 	template <typename Callback>
-	void iterateArray(simdjson::ondemand::array node, const Callback & callback) const {
-		int index = 0;
+	void iterateArray(simdjson::ondemand::array & node, const Callback & callback) const {
+		std::size_t index = 0;
 		for(auto item : node) {
 			callback(index, item.value());
 			++index;
 		}
 	}
 
-	std::size_t getObjectSize(simdjson::ondemand::object node) const {
-		return node.count_fields();
+	// Scans the object, it's only used where the size is required before the fields, such as Parser::visit.
+	std::size_t getObjectSize(simdjson::ondemand::object & node) const {
+		return node.count_fields().value();
 	}
 
+	// The values which are not used by the callback are skipped by the iterator, they are not parsed.
+	// The key refers to the string buffer in the parser, it's valid until the next parse.
 	template <typename Callback>
-	void iterateObject(simdjson::ondemand::object node, const Callback & callback) const {
-		for(auto item : node) {
-			callback(toString(item.unescaped_key()), item.value());
+	void iterateObject(simdjson::ondemand::object & node, const Callback & callback) const {
+		for(auto field : node) {
+			const std::string_view key = field.unescaped_key().value();
+			callback(JsonStringView(key.data(), key.size()), field.value().value());
 		}
 	}
 
 };
 
-metapp::Variant BackendSimdjsonOnDemand::parse(const ParserSource & source, const metapp::MetaType * prototype)
+template <typename Callback>
+ParserBackendResult BackendSimdjsonOnDemand::doParse(const ParserSource & source, const Callback & callback)
 {
-	errorString.clear();
+	return doParse(source.getText(), source.getTextLength(), source.getCapacity(), callback);
+}
 
+template <typename Callback>
+ParserBackendResult BackendSimdjsonOnDemand::doParse(
+		const char * text,
+		const std::size_t length,
+		const std::size_t capacity,
+		const Callback & callback
+	)
+{
 	try {
-		simdjson::ondemand::document document = parser.iterate(source.getText(), source.getTextLength(), source.getCapacity());
-		return GeneralParser<SimdjsonOnDemandImplement>(config, SimdjsonOnDemandImplement()).parse(std::move(document), prototype);
+		simdjson::ondemand::document document = parser.iterate(text, length, capacity);
+		GeneralParser<SimdjsonOnDemandImplement> generalParser(config, SimdjsonOnDemandImplement());
+		metapp::Variant result = callback(generalParser, document);
+		// ondemand stops at the end of the root value, anything after it, such as "5, 6", is an error.
+		if(document.current_location().error() != simdjson::OUT_OF_BOUNDS) {
+			return { metapp::Variant(), "Trailing content after the JSON document." };
+		}
+		return { std::move(result), std::string() };
 	}
 	catch(const simdjson::simdjson_error & e) {
-		errorString = e.what();
+		return { metapp::Variant(), e.what() };
+	}
+}
+
+ParserBackendResult BackendSimdjsonOnDemand::parse(const ParserSource & source, const metapp::MetaType * prototype)
+{
+	return doParse(
+		source,
+		[prototype](GeneralParser<SimdjsonOnDemandImplement> & generalParser, simdjson::ondemand::document & document) {
+			return generalParser.parse(document, prototype);
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonOnDemand::parseInto(const ParserSource & source, const metapp::Variant & target)
+{
+	return doParse(
+		source,
+		[&target](GeneralParser<SimdjsonOnDemandImplement> & generalParser, simdjson::ondemand::document & document) {
+			return generalParser.parseInto(document, target);
+		}
+	);
+}
+
+ParserBackendResult BackendSimdjsonOnDemand::parseDocument(const ParserSource & source, JsonDocument & jsonDocument)
+{
+	return doParse(
+		source,
+		[this, &jsonDocument](GeneralParser<SimdjsonOnDemandImplement> & /*generalParser*/, simdjson::ondemand::document & document) {
+			DocumentBuilder<SimdjsonOnDemandImplement>(jsonDocument, config).build(document);
+			return metapp::Variant();
+		}
+	);
+}
+
+// iterate_many in simdjson can't handle scalar documents such as `true` and `null` in the stream,
+// so the documents are split and iterated one by one. The padding of `source` is shared by all documents.
+ParserBackendResult BackendSimdjsonOnDemand::parseMany(
+		const ParserSource & source,
+		const metapp::MetaType * prototype,
+		const ParseManyCallback & callback
+	)
+{
+	const char * text = source.getText();
+	const std::size_t capacity = source.getCapacity();
+	ParserBackendResult result { metapp::Variant(), std::string() };
+	splitJsonDocuments(text, source.getTextLength(), false, [this, text, capacity, prototype, &callback, &result](
+			const std::size_t begin, const std::size_t end) -> bool {
+		result = doParse(
+			text + begin,
+			end - begin,
+			capacity - begin,
+			[prototype](GeneralParser<SimdjsonOnDemandImplement> & generalParser, simdjson::ondemand::document & document) {
+				return generalParser.parse(document, prototype);
+			}
+		);
+		if(! result.errorMessage.empty()) {
+			return false;
+		}
+		return callback(result.value);
+	});
+	result.value = metapp::Variant();
+	return result;
+}
+
+// document::at_pointer rewinds the document and walks to the value, the values before it are skipped without being parsed.
+// The skipped values are not validated.
+ParserBackendResult BackendSimdjsonOnDemand::extract(
+		const ParserSource & source,
+		const std::vector<std::string> & pointers,
+		const std::vector<const metapp::MetaType *> & prototypes,
+		std::vector<metapp::Variant> & results
+	)
+{
+	try {
+		simdjson::ondemand::document document = parser.iterate(source.getText(), source.getTextLength(), source.getCapacity());
+		GeneralParser<SimdjsonOnDemandImplement> generalParser(config, SimdjsonOnDemandImplement());
+		for(std::size_t i = 0; i < pointers.size(); ++i) {
+			if(pointers[i].empty()) {
+				// The root may be a scalar which can't be accessed as a value.
+				document.rewind();
+				results[i] = generalParser.parse(document, prototypes[i]);
+				continue;
+			}
+			simdjson::ondemand::value value;
+			const auto r = document.at_pointer(std::string_view(pointers[i].data(), pointers[i].size())).get(value);
+			if(r == simdjson::SUCCESS) {
+				results[i] = generalParser.parse(value, prototypes[i]);
+			}
+			else if(! isPointerNotFound(r)) {
+				return { metapp::Variant(), simdjson::error_message(r) };
+			}
+		}
+		return { metapp::Variant(), std::string() };
 	}
-	catch(const std::exception & e) {
-		errorString = e.what();
+	catch(const simdjson::simdjson_error & e) {
+		return { metapp::Variant(), e.what() };
 	}
-	return metapp::Variant();
+}
+
+// The values are visited while ondemand iterates them, the document is never materialized.
+// Note the sizes passed to onStartArray and onStartObject require an extra scan of each array and object.
+ParserBackendResult BackendSimdjsonOnDemand::visit(const ParserSource & source, ParserHandler & handler)
+{
+	return doParse(
+		source,
+		[&handler](GeneralParser<SimdjsonOnDemandImplement> & /*generalParser*/, simdjson::ondemand::document & document) {
+			EventWalker<SimdjsonOnDemandImplement>(handler).walk(document);
+			return metapp::Variant();
+		}
+	);
+}
+
+// ondemand has no tape, it holds the string buffer and the structural indexes.
+std::size_t BackendSimdjsonOnDemand::getMemorySize() const
+{
+	const std::size_t capacity = parser.capacity();
+	return capacity * 5 / 3 + capacity * 4;
+}
+
+void BackendSimdjsonOnDemand::releaseMemory()
+{
+	parser = simdjson::ondemand::parser(getSimdjsonMaxCapacity(config));
+	reserve();
 }
 
 std::unique_ptr<ParserBackend> createBackend_simdjsonOnDemand(const ParserConfig & config)
 {
 	return std::unique_ptr<ParserBackend>(new BackendSimdjsonOnDemand(config));
 }
-#endif
 
 
 } // namespace internal_
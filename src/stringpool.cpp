@@ -0,0 +1,107 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "jsonpp/stringpool.h"
+#include "jsonpp/hashobject.h"
+
+#include <cstring>
+
+namespace jsonpp {
+
+StringPool::StringPool(const std::size_t maxCount, const std::size_t maxLength)
+	:
+		maxCount(maxCount),
+		maxLength(maxLength),
+		count(0),
+		hitCount(0),
+		missCount(0),
+		slotList(),
+		slotMask(0),
+		arena(),
+		mutex()
+{
+}
+
+StringPool::~StringPool()
+{
+}
+
+const char * StringPool::intern(const char * s, const std::size_t length)
+{
+	if(length > maxLength) {
+		std::lock_guard<std::mutex> lock(mutex);
+		++missCount;
+		return nullptr;
+	}
+	// The hash is computed outside of the lock.
+	const uint64_t hash = internal_::hashKey(s, length);
+	std::lock_guard<std::mutex> lock(mutex);
+	if(! slotList.empty()) {
+		std::size_t slot = static_cast<std::size_t>(hash) & slotMask;
+		while(slotList[slot].s != nullptr) {
+			const Slot & item = slotList[slot];
+			if(item.hash == hash && item.length == length && memcmp(item.s, s, length) == 0) {
+				++hitCount;
+				return item.s;
+			}
+			slot = (slot + 1) & slotMask;
+		}
+	}
+	++missCount;
+	if(count >= maxCount) {
+		return nullptr;
+	}
+	// Keep the load factor below 0.5.
+	if((count + 1) * 2 > slotList.size()) {
+		rehash(slotList.empty() ? 64 : slotList.size() * 2);
+	}
+	char * pooled = static_cast<char *>(arena.allocate(length + 1, 1));
+	memcpy(pooled, s, length);
+	pooled[length] = 0;
+
+	std::size_t slot = static_cast<std::size_t>(hash) & slotMask;
+	while(slotList[slot].s != nullptr) {
+		slot = (slot + 1) & slotMask;
+	}
+	slotList[slot] = { pooled, length, hash };
+	++count;
+	return pooled;
+}
+
+std::size_t StringPool::getMemorySize() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return arena.getCapacity() + slotList.capacity() * sizeof(Slot);
+}
+
+void StringPool::rehash(const std::size_t slotCount)
+{
+	std::vector<Slot> oldSlotList(slotCount, Slot { nullptr, 0, 0 });
+	oldSlotList.swap(slotList);
+	slotMask = slotCount - 1;
+	for(const Slot & item : oldSlotList) {
+		if(item.s != nullptr) {
+			std::size_t slot = static_cast<std::size_t>(item.hash) & slotMask;
+			while(slotList[slot].s != nullptr) {
+				slot = (slot + 1) & slotMask;
+			}
+			slotList[slot] = item;
+		}
+	}
+}
+
+
+} // namespace jsonpp
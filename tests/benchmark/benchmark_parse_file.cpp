@@ -319,6 +319,7 @@ BenchmarkFunc
 	for(const auto & fileInfo : fileInfoList) {
 		metapp::Variant parsedObject = doBenchmarkParseFile<jsonpp::ParserBackendType::simdjson>(fileInfo);
 		doBenchmarkParseFile<jsonpp::ParserBackendType::cparser>(fileInfo);
+		doBenchmarkParseFile<jsonpp::ParserBackendType::simdjsonOnDemand>(fileInfo);
 
 		doBenchmarkDumpJson(parsedObject, fileInfo, true);
 		doBenchmarkDumpJson(parsedObject, fileInfo, false);
@@ -71,6 +71,39 @@ so any data types can be stored.
 `JsonObject` represents JSON object. It's heterogeneous data structure, the mapped value type is `metapp::Variant`,
 so any data types can be stored.  
 
+#### Alternative object types
+
+```c++
+class JsonHashObject;
+class JsonFlatObject : public std::vector<std::pair<std::string, metapp::Variant> >;
+```
+
+Both types can be used as the object type in `ParserConfig::setObjectType`, or as `prototype`. They are parsed and dumped
+natively without the meta interfaces, so they are as fast as `JsonObject`, and faster on wide objects since they avoid
+the node allocations in `std::map`.  
+`JsonHashObject` keeps the members in insertion order in a contiguous array, and finds a member with an open addressing
+hash table. It has `std::map` like functions `size`, `empty`, `reserve`, `clear`, `begin`, `end`, `find`, `count`, `insert`,
+`operator[]`, and `erase`. `erase` is O(n). `JsonHashObject` doesn't implement any meta interface.  
+`JsonFlatObject` keeps the members sorted by key, use `std::lower_bound` to find a member. It's derived from
+`std::vector<std::pair<std::string, metapp::Variant> >`, so it has all functions of the vector. The plain vector is not
+treated as an object, it's parsed and dumped as an array of pairs the same as other vectors.  
+For both types, if a key appears more than once in the JSON object, the first value is kept, the same as `JsonObject`.  
+`getJsonType` returns `JsonType::jtObject` for both types.
+
+#### JsonStringView
+
+```c++
+class JsonStringView;
+```
+
+`JsonStringView` is a non-owning reference to a string, similar to `std::string_view` which is not available in C++11.
+If the compiler supports C++17, `JsonStringView` converts to `std::string_view` implicitly.  
+When `JsonStringView` is used as `prototype`, or as the type of class fields or container elements, the parser doesn't
+copy the strings. The views refer to the memory in the parser, and they are valid until the next parse with the same
+`Parser`, or until the `Parser` is destroyed. This avoids the string copies, for example, when routing requests.  
+`JsonNode::getStringView()` in `JsonDocument` returns a `JsonStringView` as well.  
+`JsonStringView` is dumped as JSON string.
+
 #### Type constants
 
 There are enum values to identify the types. `jtNone` means it's not any known default data type.
@@ -137,6 +137,9 @@ If `named enum` is false, the integral values are dumped.
 Using enumerator names in the dumped JSON has advantage that, if the enumerator values changed (such as reordered), the
 correct values (after changed) can be read back by names.  
 Note: When parsing JSON document with named enumerators, `prototype` must be specified and passed to `jsonpp::Parser`.
+The names and values of each enum type are cached in hash tables on first use, both dumping and parsing named enumerators
+don't search the registered items linearly. If the output has function `writeEncodedString(const char * s, std::size_t length)`,
+such as `TextOutput`, the cached names which are already quoted and escaped are passed to it.
 
 #### Set/get indent
 
@@ -115,6 +115,163 @@ Parse JSON document in `source`.
 If you needs to repeat parsing the same document, using `ParserSource` may increase performance slightly,
 depending on the parser backend.
 
+#### parse into existing object
+
+```c++
+template <typename T>
+bool parseInto(const char * jsonText, const std::size_t length, T & target);
+
+template <typename T>
+bool parseInto(const std::string & jsonText, T & target);
+
+template <typename T>
+bool parseInto(const ParserSource & source, T & target);
+```
+
+Parse JSON document into the existing object `target`, instead of creating a new object.  
+Returns true if there is no error, false if there is any error.  
+The memory owned by `target` is reused as much as possible. For example, the capacity of `std::vector` and `std::string`
+are kept, nested containers and class objects are parsed in place. It's useful when the same document structure is parsed
+repeatedly into a long-lived object.  
+Class fields that don't appear in the JSON object keep their previous values.  
+Mappable containers such as `std::map` are parsed then assigned to `target`.  
+If there is any error, the value of `target` is unspecified. The values before the error may have been written into it,
+for example, a `std::vector` may be resized and hold some of the new elements, so don't use it until it's assigned or
+parsed successfully again.
+
+#### parse into JsonDocument
+
+```c++
+bool parseDocument(const char * jsonText, const std::size_t length, JsonDocument & document);
+bool parseDocument(const std::string & jsonText, JsonDocument & document);
+bool parseDocument(const ParserSource & source, JsonDocument & document);
+```
+
+Parse JSON document into `document`, which is a lightweight DOM declared in `jsonpp/document.h`.  
+Returns true if there is no error, false if there is any error. On error `document` is cleared.  
+All nodes, keys, and strings in `JsonDocument` are allocated from a monotonic arena owned by the document.
+Comparing to parsing into the default `JsonArray` and `JsonObject`, there are far fewer memory allocations,
+and destroying or clearing the document doesn't walk the tree.  
+Parsing into the same `JsonDocument` repeatedly reuses the arena memory.  
+The nodes are valid until the document is cleared, parsed again, or destroyed.  
+`JsonNode` is the node type. Object members are kept in the document order, `JsonNode::find` looks up a member by key.
+`JsonNode::toVariant()` converts the node to the default data types, such as `JsonArray` and `JsonObject`.  
+
+Object keys and short strings such as enum-like values usually repeat many times in a large document.
+`JsonDocument::setStringPool(std::shared_ptr<StringPool>)` sets a string pool, declared in `jsonpp/stringpool.h`,
+then each distinct string that can be pooled is stored only once, and the nodes refer to it. The pool can be shared by
+several documents, for example, a cache of many documents, and the documents keep the pool alive.
+If the document doesn't have a pool, the pool set by `ParserConfig::setStringPool` is used.  
+`StringPool(maxCount = 65536, maxLength = 64)` is bounded, strings longer than `maxLength`, or new strings after the pool
+has `maxCount` strings, are copied to the document as usual. `getHitCount()` and `getMissCount()` tell how effective the pool is.
+StringPool is thread safe, one pool can be shared by parsers running in different threads, such as the parsers in `ParserPool`
+and `ParallelParser`. `intern` locks a mutex, so a pool shared by many threads building large documents may be contended.  
+
+If `ParserConfig::enableZeroCopyString(true)` is set, the keys and strings are not copied at all, the nodes refer to
+the strings in the parser backend memory, and the document keeps that memory alive until it's cleared, parsed again,
+or destroyed. This is supported by backend `simdjson`, `cparser` and `native`. `simdjsonOnDemand` always copies the strings.
+The string pool is not used in zero copy mode.
+
+#### parse a stream of documents
+
+```c++
+using ParseManyCallback = std::function<bool (const metapp::Variant & value)>;
+
+bool parseMany(const char * jsonText, const std::size_t length, const ParseManyCallback & callback,
+	const metapp::MetaType * prototype = nullptr);
+bool parseMany(const std::string & jsonText, const ParseManyCallback & callback,
+	const metapp::MetaType * prototype = nullptr);
+bool parseMany(const ParserSource & source, const ParseManyCallback & callback,
+	const metapp::MetaType * prototype = nullptr);
+
+template <typename T, typename Callback>
+bool parseMany(const char * jsonText, const std::size_t length, const Callback & callback);
+template <typename T, typename Callback>
+bool parseMany(const std::string & jsonText, const Callback & callback);
+template <typename T, typename Callback>
+bool parseMany(const ParserSource & source, const Callback & callback);
+```
+
+Parse a stream of JSON documents separated by white spaces, such as NDJSON (newline delimited JSON, or JSON Lines).  
+`callback` is invoked with each parsed document, in the order in the stream. It returns true to continue, false to stop.  
+In the non-templated version, each document is parsed the same as `parse(source, prototype)`. In the templated version,
+`callback` has the prototype `bool callback(const T & value)`.  
+Returns true if there is no error, false if there is any error. The documents before the error are already passed to `callback`.  
+The `JsonStringView` values in a document are only valid during the `callback` call, like the strings passed to `visit`.
+Backend `cparser` and `native` reuse their memory for each document, and backend `simdjson` reuses it for each batch.
+Copy the strings, or use `std::string` in the prototype, to keep them after `callback` returns.  
+The whole input is prepared, e.g, padded, only once, so it's much faster than splitting the lines and calling `parse` on each line.  
+For backend `simdjson`, the stream is parsed in batches using `simdjson::dom::parser::parse_many`, the batch size is set by
+`ParserConfig::setBatchSize`. For the other backends, the documents are located by scanning the brackets and strings,
+then parsed one by one.
+
+#### extract values by JSON Pointer
+
+```c++
+std::vector<metapp::Variant> extract(const char * jsonText, const std::size_t length,
+	const std::vector<std::string> & pointers,
+	const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>());
+std::vector<metapp::Variant> extract(const std::string & jsonText,
+	const std::vector<std::string> & pointers,
+	const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>());
+std::vector<metapp::Variant> extract(const ParserSource & source,
+	const std::vector<std::string> & pointers,
+	const std::vector<const metapp::MetaType *> & prototypes = std::vector<const metapp::MetaType *>());
+```
+
+Extract the values at the JSON Pointers (RFC 6901), such as `"/user/id"`, `"/list/0"`, or `""` for the whole document.
+Only the matched values are converted, the other values are skipped.  
+`prototypes[i]` is the prototype of the value at `pointers[i]`. If `prototypes` has less elements than `pointers`,
+or the prototype is nullptr, the value is parsed as the default types.  
+Returns the values in the same order as `pointers`. If a value is not found, it's empty.
+If there is any error, such as the document is malformed or a pointer is invalid, `hasError()` returns true and all values are empty.  
+For backend `simdjson`, the unmatched values are skipped using the jump offsets in the simdjson tape.
+For backend `simdjsonOnDemand`, each matched value is found by walking the document, the values before it are skipped.
+For backend `native`, the unmatched values are skipped using the container ends found by the structural scan.
+For backend `cparser`, the whole document is parsed, only the matched values are converted.  
+Backend `simdjson` and `cparser` validate the whole document. Backend `simdjsonOnDemand` and `native` don't validate
+the unmatched values, the same as the fields skipped by the prototype in `parse`, so a malformed value that is not extracted
+is not an error, and `simdjsonOnDemand` doesn't check the content after the document.
+
+```c++
+std::vector<metapp::Variant> values = parser.extract(jsonText, { "/user/id", "/meta/ts" });
+```
+
+#### visit the values with event handler
+
+```c++
+bool visit(const char * jsonText, const std::size_t length, ParserHandler & handler);
+bool visit(const std::string & jsonText, ParserHandler & handler);
+bool visit(const ParserSource & source, ParserHandler & handler);
+```
+
+Parse the document and pass the values to `handler` as events (SAX style), in document order.
+No `metapp::Variant` is created, this is the fastest way to stream the values into user's own data structure.  
+Returns true on success. On failure, the events before the error may have been emitted.  
+`ParserHandler` has below virtual functions, the default implementations do nothing, override the ones that are needed.
+
+```c++
+class ParserHandler
+{
+public:
+	virtual void onNull();
+	virtual void onBool(const bool value);
+	virtual void onInt(const int64_t value);
+	virtual void onUint(const uint64_t value);
+	virtual void onDouble(const double value);
+	virtual void onString(const JsonStringView & value);
+	virtual void onStartObject(const std::size_t size);
+	virtual void onKey(const JsonStringView & key);
+	virtual void onEndObject();
+	virtual void onStartArray(const std::size_t size);
+	virtual void onEndArray();
+};
+```
+
+`onKey` is emitted before the value of each object member. `size` is the member count of the object or the element count of the array.  
+The string views passed to `onString` and `onKey` are only valid during the call, the same as the `JsonStringView` values passed to the `parseMany` callback.  
+For backend `simdjsonOnDemand`, the sizes require an extra scan of each array and object.
+
 #### Error handling
 
 ```c++
@@ -129,6 +286,20 @@ So `parse` functions don't throw any exceptions.
 `metapp` works if exceptions are disabled in compiler, for the parser backend, please check their document to see
 if exceptions can be disabled.
 
+#### Memory held by the parser
+
+```c++
+std::size_t getMemorySize() const;
+void releaseMemory();
+```
+
+A parser keeps the memory of the backend, such as the simdjson buffers, or the arena that backend `cparser` allocates
+the parsed tree from, for the next parse. The memory grows to fit the largest document parsed and never shrinks.  
+`getMemorySize()` returns the approximate bytes held by the parser.  
+`releaseMemory()` releases the memory, the next parse allocates again. The `JsonStringView` values returned by the last parse
+become invalid.  
+`ParserPool` uses them to limit the memory of the pooled parsers.
+
 #### The input data
 
 The input data must be UTF-8 text or plain ASCII text which is a subset of UTF-8. If the input is other unicode encoding,
@@ -272,10 +443,14 @@ enum class ParserBackendType
 {
 	simdjson,
 	cparser,
+	simdjsonOnDemand,
+	native,
+	automatic,
 };
 ```
 
-Please see section "Parser backend comparison" for more details.
+Please see section "Parser backend comparison" for more details.  
+`automatic` chooses among `cparser`, `native` and `simdjson` for each document, see "Set/get automatic backend thresholds".
 
 Note `setBackendType` accepts the backend type as template argument because then the linker can eliminate the unused
 backend from the executable.
@@ -290,6 +465,131 @@ ParserConfig & enableComment(const bool enable);
 Set whether C style comment should be parsed in the JSON document. Default is false.  
 Note not all backends support comment. Currently only `ParserBackendType::cparser` supports comment.  
 
+#### Set/get batch size
+
+```c++
+std::size_t getBatchSize() const;
+ParserConfig & setBatchSize(const std::size_t batchSize);
+```
+
+Set the batch size in bytes used by `Parser::parseMany` in backend `simdjson`. Default is 1000000.
+The batch size must be larger than the largest document in the stream.
+
+#### Set/get zero copy string
+
+```c++
+bool allowZeroCopyString() const;
+ParserConfig & enableZeroCopyString(const bool enable);
+```
+
+Set whether `Parser::parseDocument` refers to the strings in the parser memory instead of copying them.
+Default is false. See "parse into JsonDocument" for details.
+
+#### Set/get string pool
+
+```c++
+const std::shared_ptr<StringPool> & getStringPool() const;
+ParserConfig & setStringPool(const std::shared_ptr<StringPool> & stringPool);
+```
+
+Set the string pool used by `Parser::parseDocument`. Default is nullptr, which doesn't pool the strings.
+See "parse into JsonDocument" for details.
+
+#### Set/get capacity and memory release
+
+```c++
+std::size_t getInitialCapacity() const;
+ParserConfig & setInitialCapacity(const std::size_t initialCapacity);
+std::size_t getMaxCapacity() const;
+ParserConfig & setMaxCapacity(const std::size_t maxCapacity);
+std::size_t getReleaseMemorySize() const;
+ParserConfig & setReleaseMemorySize(const std::size_t releaseMemorySize);
+bool allowHugePages() const;
+ParserConfig & enableHugePages(const bool enable);
+```
+
+`setInitialCapacity` sets the document size in bytes that the simdjson and native backends allocate the buffers for when the parser
+is created, so the first parses don't allocate. The buffers still grow for larger documents. Default is 0.  
+`setMaxCapacity` sets the largest document size in bytes that the simdjson and native backends accept, parsing larger documents
+fails with an error. Default is 0, which means the simdjson limit of 4GB.  
+`setReleaseMemorySize` makes the parser call `releaseMemory()` before a parse if `getMemorySize()` is larger than the
+size, the memory is allocated again for the initial capacity. The memory grown by a parse is released by the next parse,
+not right after it, so the `JsonStringView` values returned by a parse are valid until the next parse as usual. It's useful when an occasional huge document shouldn't
+pin its buffers in a long lived parser. Default is 0, which never releases.  
+`enableHugePages(true)` makes backend `simdjson` advise the kernel (with `madvise`) to back its large buffers with
+transparent huge pages, which reduces TLB misses on large documents. The buffers are allocated before they are touched
+so the advice can take effect. It only works on Linux with transparent huge pages in `madvise` mode, it's ignored by
+the other backends and systems. Default is false.  
+The capacity settings are ignored by backend `cparser`.
+
+```c++
+jsonpp::ParserConfig config;
+config.setBackendType<jsonpp::ParserBackendType::simdjson>();
+// Ready for 1MB documents, reject documents larger than 64MB, and drop the buffers once they grow beyond 16MB.
+config.setInitialCapacity(1024 * 1024).setMaxCapacity(64 * 1024 * 1024).setReleaseMemorySize(16 * 1024 * 1024);
+```
+
+#### Set/get automatic backend thresholds
+
+```c++
+struct AutoBackendThresholds
+{
+	std::size_t smallSize;
+	std::size_t largeSize;
+	std::size_t largeSparseSize;
+};
+
+const AutoBackendThresholds & getAutoThresholds() const;
+ParserConfig & setAutoThresholds(const AutoBackendThresholds & autoThresholds);
+
+AutoBackendThresholds calibrateAutoBackend(const ParserConfig & config = ParserConfig());
+```
+
+The thresholds are used by `ParserBackendType::automatic` to choose the backend for each document. No backend is the
+fastest for all documents. `cparser` has the least setup cost so it's the fastest on tiny documents, `simdjson` is the
+fastest on large documents, and `native` is in between.  
+The documents shorter than `smallSize` bytes are parsed by `cparser`. The other documents are parsed by `simdjson` if they
+have at least `largeSize` bytes, otherwise by `native`. Before comparing with `largeSize`, the first 1KB of the document
+is sampled, if more than 3/4 of the bytes are in strings or are white spaces, such as long texts or pretty printed
+documents, `largeSparseSize` is used instead of `largeSize`.  
+The defaults are `smallSize` = 512, `largeSize` = 64KB and `largeSparseSize` = 4KB, they are rough values for current x86-64
+computers. `calibrateAutoBackend` measures the three backends with generated documents from 64 bytes to 1MB on the running
+machine and returns the thresholds. The result is ordered, `smallSize` <= `largeSparseSize` <= `largeSize`, and each one
+is at most 2MB. It takes about one second, so call it once at startup and reuse the result.  
+If comment is enabled, `cparser` is always used since it's the only backend that supports comment.  
+Note the backends don't behave exactly the same on invalid documents, for example, a trailing comma is only accepted
+by `cparser`, see "Parser backend comparison". Each backend keeps its own memory, `Parser::getMemorySize` returns the total.
+
+```c++
+jsonpp::ParserConfig config;
+config.setBackendType<jsonpp::ParserBackendType::automatic>();
+config.setAutoThresholds(jsonpp::calibrateAutoBackend());
+jsonpp::Parser parser(config);
+```
+
+#### Include/exclude object keys
+
+```c++
+static constexpr int anyDepth = -1;
+ParserConfig & includeKeys(const std::vector<std::string> & keys, const int depth = anyDepth);
+ParserConfig & excludeKeys(const std::vector<std::string> & keys, const int depth = anyDepth);
+```
+
+Filter the object members by key when parsing without prototype. The values of the filtered out members are skipped
+in the backend, they are not converted to Variant.  
+`depth` is the count of arrays and objects that contain the object, the root object has depth 0.
+If `depth` is `anyDepth`, the keys apply to the objects at all depths.  
+If there is any included key for the depth of an object (including `anyDepth`), only the members with the included keys are parsed.
+The members with excluded keys are never parsed, exclusion takes precedence over inclusion.  
+The filter applies to the default object type, and the object type set by `setObjectType`.
+It doesn't apply to the objects parsed with prototype, such as a class or `std::map<std::string, int>`.
+
+```c++
+// Drop the large "entities" blobs in any object.
+jsonpp::ParserConfig config;
+config.excludeKeys({ "entities" });
+```
+
 #### Set/get array type
 
 ```c++
@@ -325,6 +625,8 @@ If the argument `prototype` in `Parser::parse` is not nullptr, the object type i
 as the object type.  
 The object type can be `std::map<std::string, T>`, `std::unordered_map<std::string, T>`, or any containers that
 implements meta interface `metapp::MetaMappable`. The type `T` must be able to casted from the value in the JSON document.  
+The object type can also be `jsonpp::JsonHashObject` or `jsonpp::JsonFlatObject`, which are parsed natively and
+are faster than the other non-default types. See the document for common data types for details.  
 The object type can also be sequence containers such as `std::vector`, `std::deque`, `std::list`, `std::array` with enough elements,
 or any containers that implements meta interface `metapp::MetaIndexable`. The element type can be `std::pair<std::string, T>`, or
 any sequence containers which size can grow to at least 2.
@@ -351,13 +653,255 @@ class ParserSource
 public:
 	ParserSource();
 	ParserSource(const char * cstr, const std::size_t cstrLength);
+	ParserSource(const char * cstr, const std::size_t cstrLength, const std::size_t capacity);
 	explicit ParserSource(const std::string & str);
 	explicit ParserSource(std::string && str);
+
+	static constexpr std::size_t filePadding = 64;
+	static ParserSource fromFile(const std::string & fileName);
+
+	bool hasError() const;
+	const std::string & getError() const;
 };
 ```
 
 `ParserSource` has constructors that accept `std::string` or C string which is the JSON document.  
-Note `ParserSource` refers to the string, so the content must be available until the `ParserSource` is destroyed.
+Note `ParserSource` refers to the string, so the content must be available until the `ParserSource` is destroyed.  
+Some parser backends, such as `simdjson`, require some readable bytes after the text (padding). If the source doesn't have enough
+capacity, the text is copied to a padded scratch buffer owned by `Parser`, the buffer is reused across parses so there is no
+allocation once it's large enough. A `std::string` moved into `ParserSource` is padded in place instead.  
+`capacity` in the constructor is the size of the readable memory starting from `cstr`. If the caller's buffer is already padded,
+such as a network buffer, passing the capacity lets the text be parsed in place without copying.
+
+`fromFile` loads the JSON document from file `fileName`. On POSIX systems, if the unused bytes after the end of the file in
+the last memory page are no less than `filePadding`, the file is memory mapped, otherwise the file is read
+into a buffer with `filePadding` bytes padding. In both cases the parser backends don't copy the content again.
+The returned `ParserSource` owns the mapping or the buffer.  
+If the file can't be read, `hasError()` returns true, and parsing the source fails with the same error message.
+
+## Class ParallelParser
+
+#### Header
+
+```c++
+#include "jsonpp/parallelparser.h"
+```
+
+```c++
+enum class ParallelOrder
+{
+	inputOrder,
+	fastestFirst
+};
+
+class ParallelParser
+{
+public:
+	ParallelParser();
+	explicit ParallelParser(const ParserConfig & config, const std::size_t threadCount = 0);
+
+	std::size_t getThreadCount() const;
+
+	ParallelOrder getOrder() const;
+	ParallelParser & setOrder(const ParallelOrder order);
+
+	std::size_t getChunkSize() const;
+	ParallelParser & setChunkSize(const std::size_t chunkSize);
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	bool parseMany(const char * jsonText, const std::size_t length, const ParseManyCallback & callback,
+		const metapp::MetaType * prototype = nullptr);
+	bool parseMany(const std::string & jsonText, const ParseManyCallback & callback,
+		const metapp::MetaType * prototype = nullptr);
+
+	template <typename T, typename Callback>
+	bool parseMany(const char * jsonText, const std::size_t length, const Callback & callback);
+	template <typename T, typename Callback>
+	bool parseMany(const std::string & jsonText, const Callback & callback);
+
+	std::vector<BatchParseResult> parseBatch(const ParserSource * sources, const std::size_t count,
+		const metapp::MetaType * prototype = nullptr);
+	std::vector<BatchParseResult> parseBatch(const std::vector<ParserSource> & sources,
+		const metapp::MetaType * prototype = nullptr);
+	template <typename T>
+	std::vector<BatchParseResult> parseBatch(const std::vector<ParserSource> & sources);
+
+	const BatchParseStats & getBatchStats() const;
+};
+
+struct BatchParseResult
+{
+	metapp::Variant value;
+	std::string errorMessage;
+};
+
+struct BatchParseStats
+{
+	std::size_t documentCount;
+	std::size_t failedCount;
+	std::size_t byteCount;
+	std::size_t threadCount;
+	std::chrono::nanoseconds elapsedTime;
+	std::chrono::nanoseconds parseTime;
+	std::chrono::nanoseconds maxDocumentTime;
+};
+```
+
+`ParallelParser` parses NDJSON (newline delimited JSON, or JSON Lines) with multiple threads. It has the same `parseMany` functions
+as `Parser::parseMany`.  
+The input is split at new line boundaries into chunks of about `getChunkSize()` bytes (default is 1MB), and each worker thread
+parses the chunks with its own `Parser` which is created with `config`. The parsers are reused in the next `parseMany`.
+Since the input is split at new lines, each document must be in a single line, as NDJSON requires.  
+If `threadCount` is 0, `std::thread::hardware_concurrency()` is used. If there is only one chunk, the input is parsed
+in the calling thread.  
+The worker threads are started by the first call that needs them, then they wait for the next `parseMany` or `parseBatch`
+and are stopped when the `ParallelParser` is destroyed, so a call doesn't pay for starting threads. The functions must not be
+called concurrently on the same `ParallelParser`.  
+If the order is `ParallelOrder::inputOrder` (the default), `callback` is invoked in the calling thread, with the documents in the same
+order as in the input. The workers only run a few chunks ahead of the callback, so the memory usage is bounded.  
+If the order is `ParallelOrder::fastestFirst`, `callback` is invoked in the worker threads as soon as a chunk is parsed,
+the documents in the same chunk are in order, but the order among chunks is undetermined.  
+In both orders, `callback` is never invoked concurrently. If `callback` returns false, or throws an exception, or any chunk fails to parse,
+all workers stop as soon as possible, and the documents after the failure are not passed to `callback`.
+The exception message is the error message.  
+The documents of a chunk are buffered before they are passed to `callback`, while the worker's parser goes on parsing
+other documents. So if the prototype may hold `JsonStringView`, such as a class field or a container element of
+`JsonStringView`, `parseMany` fails without parsing anything and `hasError()` returns true. Use `std::string` instead.  
+
+`parseBatch` parses many independent documents, such as the messages drained from a queue, or the files in a directory.
+The documents are spread over the worker threads, each worker takes the next unparsed document, so a few large documents
+don't leave the other workers idle. The workers use the same reused parsers as `parseMany`, so the backend memory is reused
+across the documents and the batches. If there is only one thread or one document, the batch is parsed in the calling thread.  
+The results are returned in the same order as `sources`. A document that fails to parse doesn't stop the others, its `value`
+is empty and `errorMessage` is the error. `hasError()` returns true if any document fails, and `getError()` returns the error
+of the first failed document.  
+Each worker parses many documents with the same `Parser`, so a `JsonStringView` in a result would refer to the parser memory
+that is overwritten by the next document. If the prototype may hold `JsonStringView`, such as a class field or a container
+element of `JsonStringView`, the batch is rejected, every result fails and `hasError()` returns true. Use `std::string` instead.  
+`getBatchStats()` returns the statistics of the last batch. `elapsedTime` is the wall clock time of the batch, `parseTime` is
+the time spent parsing summed over all threads, and `maxDocumentTime` is the longest time spent on a single document.
+If `parseTime` is much smaller than `elapsedTime * threadCount`, the batch is too small or dominated by a single large document.  
+
+```c++
+jsonpp::ParallelParser parser(jsonpp::ParserConfig(), 8);
+std::vector<jsonpp::ParserSource> sources;
+for(const auto & fileName : fileNameList) {
+	sources.push_back(jsonpp::ParserSource::fromFile(fileName));
+}
+const std::vector<jsonpp::BatchParseResult> results = parser.parseBatch<MyRecord>(sources);
+```
+
+## Class ParserPool
+
+#### Header
+
+```c++
+#include "jsonpp/parserpool.h"
+```
+
+```c++
+class ParserPool
+{
+public:
+	class Lease
+	{
+	public:
+		Lease(Lease && other) noexcept;
+		~Lease();
+
+		Parser & operator * () const;
+		Parser * operator -> () const;
+		Parser & get() const;
+	};
+
+	struct Stats
+	{
+		std::size_t inUseCount;
+		std::size_t idleCount;
+		std::size_t idleMemorySize;
+		std::size_t createdCount;
+		std::size_t trimmedCount;
+	};
+
+public:
+	explicit ParserPool(const ParserConfig & config = ParserConfig(), const std::size_t maxIdleCount = 0);
+
+	Lease acquire();
+
+	std::size_t getMaxIdleCount() const;
+
+	std::size_t getMemoryCeiling() const;
+	ParserPool & setMemoryCeiling(const std::size_t memoryCeiling);
+
+	Stats getStats() const;
+};
+```
+
+`ParserPool` hands out parsers created with `config` to multiple threads. Constructing a `Parser` for each request is expensive,
+and keeping one parser per thread holds the peak memory forever. The pool reuses the parsers and bounds their memory.  
+`acquire()` returns a `Lease` which owns an idle parser, or a new parser if there is no idle one. When the lease is destroyed,
+the parser is returned to the pool. The pool must outlive all leases.  
+At most `maxIdleCount` parsers are kept in the pool, the extra returned parsers are destroyed. If `maxIdleCount` is 0,
+`std::thread::hardware_concurrency()` is used.  
+If the memory ceiling is not 0, when a parser is returned and it holds more memory than the ceiling, such as after parsing an
+unusually large document, its memory is released by `Parser::releaseMemory()`. The default ceiling is 0, which means no ceiling.  
+`getStats()` returns the count of parsers in use, the count of idle parsers, the bytes held by the idle parsers,
+the count of parsers created, and the count of times the memory of a parser is released due to the ceiling.  
+All functions are thread safe. The idle parsers are kept in a lock-free list, `acquire()` and returning a parser never lock.
+
+```c++
+jsonpp::ParserPool pool(jsonpp::ParserConfig(), 8);
+pool.setMemoryCeiling(16 * 1024 * 1024);
+
+// In any thread
+{
+	jsonpp::ParserPool::Lease parser = pool.acquire();
+	metapp::Variant value = parser->parse(jsonText);
+}
+```
+
+## Class IncrementalParser
+
+#### Header
+
+```c++
+#include "jsonpp/incrementalparser.h"
+```
+
+```c++
+class IncrementalParser
+{
+public:
+	IncrementalParser();
+	explicit IncrementalParser(const ParserConfig & config);
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	bool feed(const char * data, const std::size_t length);
+	bool feed(const std::string & data);
+
+	bool isComplete() const;
+
+	metapp::Variant finish(const metapp::MetaType * prototype = nullptr);
+	template <typename T>
+	T finish();
+
+	void reset();
+};
+```
+
+`IncrementalParser` parses a JSON document which arrives in chunks, such as from a socket, so the processing can start
+before the whole document is received, and the whole document is never buffered.  
+`feed` tokenizes the chunk immediately. The chunks can be split at any byte, even in the middle of a string or a number.
+`feed` returns false if there is any error, the following chunks are ignored until `finish` or `reset`.  
+`isComplete` returns true if a complete JSON value has been fed. A number at the root level is complete only after `finish`.  
+`finish` ends the document and returns the parsed value, or empty Variant on error. The result is the same as `Parser::parse`
+with the same `config` and `prototype`. The next `feed` after `finish` starts a new document, the memory is reused.  
+The parsed nodes are stored in a `JsonDocument` arena while feeding, and are converted to the result in `finish`.
+`IncrementalParser` has its own tokenizer, the parser backend in `config` is not used. The string pool and comments in `config` are supported.  
 
 ## Example code
 
@@ -665,15 +1209,33 @@ ExampleFunc
 
 `ParserBackendType::simdjson` - [simdjson project](https://github.com/simdjson/simdjson).  
 `ParserBackendType::cparser` - [json-parser project](https://github.com/json-parser/json-parser).  
-
-| Feature            | simdjson    | cparser       |
-|--------------------|-------------|---------------|
-| Performance        | Very high   | Not very slow |
-| Input encoding     | UTF-8       | UTF-8         |
-| \0' in JSON string | Support     | Not support   |
-| Comment in JSON    | Not support | Support       |
-| Trailing comma     | Reject      | Pass          |
-| Memory usage       | High        | Low           |
+`ParserBackendType::simdjsonOnDemand` - simdjson project, using the On-Demand API.  
+`ParserBackendType::native` - the built-in parser of jsonpp.  
+`IncrementalParser` is not a backend, it's listed because it has its own tokenizer, which parses the chunks as they arrive.
+Its result is the same as `Parser::parse` for valid JSON, the differences are in which invalid input is rejected.  
+
+| Feature            | simdjson    | cparser       | simdjsonOnDemand | native        | IncrementalParser |
+|--------------------|-------------|---------------|------------------|---------------|-------------------|
+| Performance        | Very high   | Not very slow | Very high        | High          | Not very slow     |
+| Input encoding     | UTF-8       | UTF-8         | UTF-8            | UTF-8         | UTF-8             |
+| UTF-8 validation   | Yes         | No            | Yes              | No            | No                |
+| \0' in JSON string | Support     | Not support   | Support          | Support       | Support           |
+| Comment in JSON    | Not support | Support       | Not support      | Not support   | Support           |
+| Trailing comma     | Reject      | Pass          | Reject           | Reject        | Reject            |
+| Memory usage       | High        | Low           | High             | Low           | Low               |
+
+`simdjsonOnDemand` only parses the values that are requested. When parsing with a prototype, the object fields that don't
+exist in the prototype are skipped without being converted, so it's much faster than `simdjson` when the prototype only needs
+a small part of a large document. When parsing without prototype, all values are requested, and its performance is similar
+to `simdjson`. Note the skipped values are not fully validated.
+The On-Demand API doesn't know the size of an array or object before iterating it, so the elements are appended while iterating
+instead of counting them first. Only `visit` counts them, because `onStartArray` and `onStartObject` need the sizes.  
+
+`native` doesn't build any intermediate tree. It first scans the document for the structural characters, using SSE2
+where the CPU supports it, and records where each array and object ends and how many items it has. Then the values are read
+directly into the result, the strings are unescaped into a single buffer which is reused by the next parse. The values that
+are not needed, such as the fields that don't exist in the prototype, are skipped using the recorded container ends, so they
+are not fully validated. The memory used is proportional to the number of arrays and objects and the length of the strings.  
 
 Note: simdjson has very high performance on computers with SIMD instructions. For computers without SIMD support, the performance
 is not that high.
@@ -0,0 +1,242 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+
+#include "jsonpp/parser.h"
+#include "jsonpp/document.h"
+#include "jsonpp/stringpool.h"
+#include "metapp/allmetatypes.h"
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEMPLATE_LIST_TEST_CASE("JsonDocument, scalar root", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	jsonpp::JsonDocument document;
+
+	REQUIRE(parser.parseDocument(std::string("5"), document));
+	REQUIRE(document.getRoot().getType() == jsonpp::JsonType::jtInt);
+	REQUIRE(document.getRoot().getInt() == 5);
+
+	REQUIRE(parser.parseDocument(std::string("null"), document));
+	REQUIRE(document.getRoot().isNull());
+
+	REQUIRE(parser.parseDocument(std::string(R"("abc")"), document));
+	REQUIRE(document.getRoot().getType() == jsonpp::JsonType::jtString);
+	REQUIRE(std::string(document.getRoot().getString(), document.getRoot().getStringLength()) == "abc");
+}
+
+TEMPLATE_LIST_TEST_CASE("JsonDocument, array and object", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	jsonpp::JsonDocument document;
+
+	REQUIRE(parser.parseDocument(std::string(R"(
+		{
+			"b" : true,
+			"a" : [ 1, -2, 3.5, "x", null, [], {} ],
+			"o" : { "k" : "v" }
+		}
+	)"), document));
+	const jsonpp::JsonNode & root = document.getRoot();
+	REQUIRE(root.getType() == jsonpp::JsonType::jtObject);
+	REQUIRE(root.getSize() == 3);
+	// Members are kept in the document order.
+	REQUIRE(std::string(root.getMember(0).key) == "b");
+	REQUIRE(std::string(root.getMember(1).key) == "a");
+	REQUIRE(root.find("b")->getBool());
+	REQUIRE(root.find("notExist") == nullptr);
+
+	const jsonpp::JsonNode & array = *root.find("a");
+	REQUIRE(array.getType() == jsonpp::JsonType::jtArray);
+	REQUIRE(array.getSize() == 7);
+	REQUIRE(array[0].getInt() == 1);
+	REQUIRE(array[1].getInt() == -2);
+	REQUIRE(array[2].getReal() == Approx(3.5));
+	REQUIRE(std::string(array[3].getString()) == "x");
+	REQUIRE(array[4].isNull());
+	REQUIRE(array[5].getType() == jsonpp::JsonType::jtArray);
+	REQUIRE(array[5].getSize() == 0);
+	REQUIRE(array[6].getType() == jsonpp::JsonType::jtObject);
+	REQUIRE(array[6].getSize() == 0);
+
+	REQUIRE(std::string(root.find("o")->find("k")->getString()) == "v");
+
+	const metapp::Variant var = root.toVariant();
+	REQUIRE(var.get<jsonpp::JsonObject &>()["o"].get<jsonpp::JsonObject &>()["k"].get<const std::string &>() == "v");
+	REQUIRE(var.get<jsonpp::JsonObject &>()["a"].get<jsonpp::JsonArray &>().size() == 7);
+}
+
+// Backend simdjsonOnDemand builds the containers in scratch lists which are reused by the containers of the same depth.
+TEMPLATE_LIST_TEST_CASE("JsonDocument, nested containers", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	jsonpp::JsonDocument document;
+
+	REQUIRE(parser.parseDocument(std::string(R"(
+		[ [ 1, [ 2, 3 ], 4 ], { "a" : [ 5 ], "b" : { "c" : 6 } }, [ 7, 8, 9 ] ]
+	)"), document));
+	const jsonpp::JsonNode & root = document.getRoot();
+	REQUIRE(root.getSize() == 3);
+	REQUIRE(root[0].getSize() == 3);
+	REQUIRE(root[0][0].getInt() == 1);
+	REQUIRE(root[0][1].getSize() == 2);
+	REQUIRE(root[0][1][1].getInt() == 3);
+	REQUIRE(root[0][2].getInt() == 4);
+	REQUIRE(root[1].getSize() == 2);
+	REQUIRE((*root[1].find("a"))[0].getInt() == 5);
+	REQUIRE(root[1].find("b")->find("c")->getInt() == 6);
+	REQUIRE(root[2].getSize() == 3);
+	REQUIRE(root[2][0].getInt() == 7);
+	REQUIRE(root[2][2].getInt() == 9);
+}
+
+TEMPLATE_LIST_TEST_CASE("JsonDocument, reuse and clear", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	jsonpp::JsonDocument document;
+
+	std::string jsonText = "[";
+	for(int i = 0; i < 1000; ++i) {
+		if(i > 0) {
+			jsonText += ",";
+		}
+		jsonText += R"({ "name" : "abcdefghijklmn", "value" : )" + std::to_string(i) + "}";
+	}
+	jsonText += "]";
+
+	REQUIRE(parser.parseDocument(jsonText, document));
+	REQUIRE(document.getRoot().getSize() == 1000);
+	REQUIRE(document.getRoot()[999].find("value")->getInt() == 999);
+	const auto memorySize = document.getMemorySize();
+	REQUIRE(memorySize > 0);
+
+	REQUIRE(parser.parseDocument(jsonText, document));
+	REQUIRE(document.getRoot().getSize() == 1000);
+	// The largest block is kept, parsing the same text again doesn't grow the memory.
+	REQUIRE(document.getMemorySize() <= memorySize);
+
+	jsonpp::JsonDocument moved(std::move(document));
+	REQUIRE(moved.getRoot().getSize() == 1000);
+	REQUIRE(document.getRoot().getType() == jsonpp::JsonType::jtNone);
+
+	REQUIRE(! parser.parseDocument(std::string("[1, "), moved));
+	REQUIRE(moved.getRoot().getType() == jsonpp::JsonType::jtNone);
+}
+
+TEMPLATE_LIST_TEST_CASE("JsonDocument, string pool", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	const std::string jsonText = R"([
+		{ "id" : 1, "lang" : "en", "text" : "a long string which is not pooled" },
+		{ "id" : 2, "lang" : "en", "text" : "a long string which is not pooled" }
+	])";
+
+	SECTION("pool in document") {
+		jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+		auto stringPool = std::make_shared<jsonpp::StringPool>(100, 8);
+		jsonpp::JsonDocument document;
+		document.setStringPool(stringPool);
+		REQUIRE(parser.parseDocument(jsonText, document));
+
+		const jsonpp::JsonNode & root = document.getRoot();
+		REQUIRE(root[0].getMember(0).key == root[1].getMember(0).key);
+		REQUIRE(root[0].find("lang")->getString() == root[1].find("lang")->getString());
+		REQUIRE(std::string(root[1].find("lang")->getString()) == "en");
+		REQUIRE(root[0].find("text")->getString() != root[1].find("text")->getString());
+		REQUIRE(std::string(root[1].find("text")->getString()) == "a long string which is not pooled");
+
+		// "id", "lang", "text", "en"
+		REQUIRE(stringPool->getCount() == 4);
+		REQUIRE(stringPool->getHitCount() == 4);
+		REQUIRE(stringPool->getMissCount() == 6);
+	}
+	SECTION("pool in ParserConfig, shared by documents") {
+		auto stringPool = std::make_shared<jsonpp::StringPool>();
+		jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>().setStringPool(stringPool));
+		jsonpp::JsonDocument document1;
+		jsonpp::JsonDocument document2;
+		REQUIRE(parser.parseDocument(jsonText, document1));
+		REQUIRE(parser.parseDocument(jsonText, document2));
+		REQUIRE(document1.getStringPool() == stringPool);
+		REQUIRE(document1.getRoot()[0].find("text")->getString() == document2.getRoot()[1].find("text")->getString());
+		stringPool.reset();
+		// The documents keep the pool alive.
+		REQUIRE(std::string(document2.getRoot()[0].find("lang")->getString()) == "en");
+	}
+	SECTION("bounded pool") {
+		jsonpp::StringPool stringPool(2, 8);
+		REQUIRE(stringPool.intern("a", 1) != nullptr);
+		REQUIRE(stringPool.intern("b", 1) != nullptr);
+		REQUIRE(stringPool.intern("c", 1) == nullptr);
+		REQUIRE(stringPool.intern("123456789", 9) == nullptr);
+		REQUIRE(std::string(stringPool.intern("a", 1)) == "a");
+		REQUIRE(stringPool.getCount() == 2);
+		REQUIRE(stringPool.getHitCount() == 1);
+		REQUIRE(stringPool.getMissCount() == 4);
+	}
+	SECTION("pool shared by parsers in different threads") {
+		auto stringPool = std::make_shared<jsonpp::StringPool>();
+		const jsonpp::ParserConfig config = jsonpp::ParserConfig().setBackendType<backendType>().setStringPool(stringPool);
+		constexpr int threadCount = 4;
+		constexpr int documentCount = 50;
+		std::vector<jsonpp::JsonDocument> documentList(threadCount * documentCount);
+		std::vector<std::thread> threadList;
+		for(int t = 0; t < threadCount; ++t) {
+			threadList.emplace_back([t, &config, &jsonText, &documentList]() {
+				jsonpp::Parser parser(config);
+				for(int i = 0; i < documentCount; ++i) {
+					parser.parseDocument(jsonText, documentList[t * documentCount + i]);
+				}
+			});
+		}
+		for(auto & thread : threadList) {
+			thread.join();
+		}
+		// "id", "lang", "text", "en"
+		REQUIRE(stringPool->getCount() == 4);
+		const char * lang = documentList[0].getRoot()[0].find("lang")->getString();
+		for(const auto & document : documentList) {
+			REQUIRE(document.getRoot()[1].find("lang")->getString() == lang);
+		}
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("JsonDocument, zero copy string", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>().enableZeroCopyString(true));
+	jsonpp::JsonDocument document;
+	REQUIRE(parser.parseDocument(std::string(R"({ "name" : "abc", "list" : [ "x\ty" ] })"), document));
+	// Parsing another document doesn't affect `document`, it keeps the parser memory alive.
+	jsonpp::JsonDocument other;
+	REQUIRE(parser.parseDocument(std::string(R"({ "other" : "123456" })"), other));
+
+	const jsonpp::JsonNode & root = document.getRoot();
+	REQUIRE(std::string(root.getMember(0).key) == "name");
+	REQUIRE(root.find("name")->getStringView() == jsonpp::JsonStringView("abc"));
+	REQUIRE(std::string((*root.find("list"))[0].getString()) == "x\ty");
+	REQUIRE(std::string(other.getRoot().find("other")->getString()) == "123456");
+}
+
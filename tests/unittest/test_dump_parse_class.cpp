@@ -50,3 +50,54 @@ TEMPLATE_LIST_TEST_CASE("DumpAndParse, std::vector<TestClass2>", "", BackendType
 	REQUIRE(var.get<const std::vector<TestClass2> &>()[1] == makeTestClass2(1));
 }
 
+
+TEMPLATE_LIST_TEST_CASE("Parse, TestClass1, skip unknown fields", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	const std::string jsonText = R"(
+		{
+			"unknown1" : { "a" : [ 1, 2, { "b" : "c" } ], "d" : null },
+			"s" : "Hello",
+			"unknown2" : [ [ 3.5, true ], "x" ],
+			"e" : "cat",
+			"unknown3" : 5
+		}
+	)";
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const TestClass1 obj = parser.parse<TestClass1>(jsonText);
+	REQUIRE(! parser.hasError());
+	REQUIRE(obj.s == "Hello");
+	REQUIRE(obj.e == TestEnum1::cat);
+	REQUIRE(obj.listDequeLong.empty());
+}
+
+TEMPLATE_LIST_TEST_CASE("Parse, TestClass1, keys in any order", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	const std::string jsonText = R"(
+		[
+			{ "e" : "dog", "s" : "a", "listDequeLong" : [ [ 1 ] ], "tuple" : [ 5, "b", [ 6 ], 7 ] },
+			{ "tuple" : [ 8, "c", [ 9 ], 10 ], "listDequeLong" : [ [ 2 ] ], "s" : "d", "e" : "cat" },
+			{ "s" : "e", "unknown" : 1, "e" : "first", "tuple" : [ 11, "f", [], 12 ] }
+		]
+	)";
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const auto objectList = parser.parse<std::vector<TestClass1> >(jsonText);
+	REQUIRE(! parser.hasError());
+	REQUIRE(objectList.size() == 3);
+
+	REQUIRE(objectList[0].e == TestEnum1::dog);
+	REQUIRE(objectList[0].s == "a");
+	REQUIRE(objectList[0].listDequeLong.front().front() == 1);
+	REQUIRE(std::get<0>(objectList[0].tuple) == 5);
+
+	REQUIRE(objectList[1].e == TestEnum1::cat);
+	REQUIRE(objectList[1].s == "d");
+	REQUIRE(objectList[1].listDequeLong.front().front() == 2);
+	REQUIRE(std::get<1>(objectList[1].tuple) == "c");
+
+	REQUIRE(objectList[2].e == TestEnum1::first);
+	REQUIRE(objectList[2].s == "e");
+	REQUIRE(objectList[2].listDequeLong.empty());
+	REQUIRE(std::get<3>(objectList[2].tuple) == 12);
+}
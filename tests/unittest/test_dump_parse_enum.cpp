@@ -26,6 +26,34 @@
 #include <unordered_map>
 #include <iostream>
 
+namespace {
+
+// The values are consecutive, and the names need escaping.
+enum class TestEnum2
+{
+	north,
+	east,
+	south,
+	west
+};
+
+} // namespace
+
+template <>
+struct metapp::DeclareMetaType <TestEnum2> : metapp::DeclareMetaTypeBase <TestEnum2>
+{
+	static const metapp::MetaEnum * getMetaEnum() {
+		static const metapp::MetaEnum metaEnum([](metapp::MetaEnum & me) {
+			me.registerValue("north", TestEnum2::north);
+			me.registerValue("ea\"st", TestEnum2::east);
+			me.registerValue("south\n", TestEnum2::south);
+			me.registerValue("west", TestEnum2::west);
+			me.registerValue("w", TestEnum2::west);
+			});
+		return &metaEnum;
+	}
+};
+
 TEMPLATE_LIST_TEST_CASE("DumpAndParse, enum", "", BackendTypes)
 {
 	constexpr auto backendType = TestType::backendType;
@@ -70,3 +98,25 @@ TEST_CASE("DumpAndParse, named enum")
 	}
 
 }
+
+TEST_CASE("DumpAndParse, named enum, escaped names")
+{
+	const std::vector<TestEnum2> enumList {
+		TestEnum2::west, TestEnum2::east, TestEnum2::south, TestEnum2::north, TestEnum2(9)
+	};
+	const std::string jsonText = jsonpp::Dumper(jsonpp::DumperConfig().enableNamedEnum(true)).dump(enumList);
+	REQUIRE(jsonText == R"(["west","ea\"st","south\n","north",9])");
+	REQUIRE(jsonpp::Parser().parse<std::vector<TestEnum2> >(jsonText) == enumList);
+}
+
+TEMPLATE_LIST_TEST_CASE("Parse, named enum, alias and unknown name", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	const auto enumList = parser.parse<std::vector<TestEnum2> >(R"([ "w", "west", "cat", "", "east" ])");
+	REQUIRE(! parser.hasError());
+	REQUIRE(enumList == std::vector<TestEnum2> {
+		TestEnum2::west, TestEnum2::west, TestEnum2::north, TestEnum2::north, TestEnum2::north
+	});
+}
@@ -96,3 +96,52 @@ TEMPLATE_LIST_TEST_CASE("DumpAndParse, object, std::map<std::string, int>", "",
 	}
 }
 
+TEMPLATE_LIST_TEST_CASE("DumpAndParse, object, JsonHashObject and JsonFlatObject", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	auto dumperConfig = DUMPER_CONFIGS();
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	const std::string sourceText = R"({ "z" : 1, "y" : [ 2, 3 ], "x" : { "w" : "v" } })";
+
+	SECTION("JsonHashObject") {
+		parserConfig.setObjectType<jsonpp::JsonHashObject>();
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(sourceText);
+		const std::string jsonText = jsonpp::Dumper(dumperConfig).dump(var);
+		// The dumped members keep the insertion order.
+		REQUIRE(jsonText.find("\"z\"") < jsonText.find("\"y\""));
+		REQUIRE(jsonText.find("\"y\"") < jsonText.find("\"x\""));
+		const metapp::Variant parsed = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = parsed.get<const jsonpp::JsonHashObject &>();
+		REQUIRE(object.find("z")->second.get<jsonpp::JsonInt>() == 1);
+		REQUIRE(object.find("y")->second.get<const jsonpp::JsonArray &>()[1].get<jsonpp::JsonInt>() == 3);
+		REQUIRE(object.find("x")->second.get<const jsonpp::JsonHashObject &>().find("w")->second.get<const std::string &>() == "v");
+	}
+	SECTION("JsonFlatObject") {
+		parserConfig.setObjectType<jsonpp::JsonFlatObject>();
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(sourceText);
+		const std::string jsonText = jsonpp::Dumper(dumperConfig).dump(var);
+		const metapp::Variant parsed = jsonpp::Parser().parse(jsonText);
+		const jsonpp::JsonObject & object = parsed.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.at("z").get<jsonpp::JsonInt>() == 1);
+		REQUIRE(object.at("y").get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == 2);
+		REQUIRE(object.at("x").get<const jsonpp::JsonObject &>().at("w").get<const std::string &>() == "v");
+	}
+}
+
+
+TEST_CASE("DumpAndParse, object, plain vector of pairs is not JsonFlatObject")
+{
+	using T = std::vector<std::pair<std::string, metapp::Variant> >;
+	const metapp::Variant var(T { { "b", 1 }, { "a", 2 } });
+	REQUIRE(! var.getMetaType()->equal(metapp::getMetaType<jsonpp::JsonFlatObject>()));
+	REQUIRE(jsonpp::getJsonType(var) != jsonpp::JsonType::jtObject);
+
+	// It's dumped as an array of pairs, the same as any other vector.
+	const std::string jsonText = jsonpp::Dumper().dump(var);
+	REQUIRE(jsonText.front() == '[');
+
+	const metapp::Variant flat(jsonpp::JsonFlatObject { { "a", 2 }, { "b", 1 } });
+	REQUIRE(jsonpp::getJsonType(flat) == jsonpp::JsonType::jtObject);
+	REQUIRE(jsonpp::Dumper().dump(flat).front() == '{');
+}
@@ -0,0 +1,156 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+
+#include "jsonpp/parser.h"
+#include "metapp/allmetatypes.h"
+
+#include <vector>
+#include <string>
+
+namespace {
+
+const std::string extractJsonText = R"({
+	"user" : { "id" : 42, "name" : "abc", "tags" : [ "a", "b" ] },
+	"list" : [ 1, 2, { "a/b" : 3, "m~n" : 4, "" : 5 } ],
+	"meta" : { "ts" : 1234567 }
+})";
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("Parser, extract", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	const std::vector<metapp::Variant> values = parser.extract(extractJsonText, {
+		"/user/id", "/meta/ts", "/list/2/a~1b", "/list/2/m~0n", "/list/2/", "/user/tags/1", "/user/name"
+	});
+	REQUIRE(! parser.hasError());
+	REQUIRE(values.size() == 7);
+	REQUIRE(values[0].get<jsonpp::JsonInt>() == 42);
+	REQUIRE(values[1].get<jsonpp::JsonInt>() == 1234567);
+	REQUIRE(values[2].get<jsonpp::JsonInt>() == 3);
+	REQUIRE(values[3].get<jsonpp::JsonInt>() == 4);
+	REQUIRE(values[4].get<jsonpp::JsonInt>() == 5);
+	REQUIRE(values[5].get<const std::string &>() == "b");
+	REQUIRE(values[6].get<const std::string &>() == "abc");
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, extract, prototypes", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	const std::vector<metapp::Variant> values = parser.extract(
+		extractJsonText,
+		{ "/user/tags", "/user/id", "/meta" },
+		{ metapp::getMetaType<std::vector<std::string> >(), metapp::getMetaType<int>() }
+	);
+	REQUIRE(! parser.hasError());
+	REQUIRE(values[0].get<const std::vector<std::string> &>() == std::vector<std::string> { "a", "b" });
+	REQUIRE(values[1].get<int>() == 42);
+	REQUIRE(values[2].get<const jsonpp::JsonObject &>().at("ts").get<jsonpp::JsonInt>() == 1234567);
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, extract, not found", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	const std::vector<metapp::Variant> values = parser.extract(extractJsonText, {
+		"/nothing", "/list/3", "/list/-", "/list/01", "/user/id/x", "/meta/ts"
+	});
+	REQUIRE(! parser.hasError());
+	REQUIRE(values.size() == 6);
+	for(std::size_t i = 0; i < 5; ++i) {
+		REQUIRE(values[i].isEmpty());
+	}
+	REQUIRE(values[5].get<jsonpp::JsonInt>() == 1234567);
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, extract, root", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	const std::vector<metapp::Variant> values = parser.extract(std::string("5"), { "", "/a" });
+	REQUIRE(! parser.hasError());
+	REQUIRE(values[0].get<jsonpp::JsonInt>() == 5);
+	REQUIRE(values[1].isEmpty());
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, extract, errors", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	SECTION("invalid pointer") {
+		const std::vector<metapp::Variant> values = parser.extract(extractJsonText, { "/user/id", "user" });
+		REQUIRE(parser.hasError());
+		REQUIRE(values.size() == 2);
+		REQUIRE(values[0].isEmpty());
+	}
+	SECTION("invalid escape") {
+		parser.extract(extractJsonText, { "/user~2" });
+		REQUIRE(parser.hasError());
+	}
+	SECTION("malformed document") {
+		const std::vector<metapp::Variant> values = parser.extract(std::string(R"({ "a" : [ 1, )"), { "/a/1" });
+		REQUIRE(parser.hasError());
+		REQUIRE(values[0].isEmpty());
+	}
+	SECTION("trailing content") {
+		parser.extract(std::string(R"({"a":1} 2)"), { "/a" });
+		if(backendType != jsonpp::ParserBackendType::simdjsonOnDemand) {
+			REQUIRE(parser.hasError());
+		}
+	}
+}
+
+// simdjsonOnDemand and native skip the unmatched values without validating them,
+// simdjson and cparser validate the whole document.
+TEMPLATE_LIST_TEST_CASE("Parser, extract, malformed unmatched values", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const bool skipWithoutValidating = (backendType == jsonpp::ParserBackendType::simdjsonOnDemand
+		|| backendType == jsonpp::ParserBackendType::native);
+
+	SECTION("malformed value after the matched value") {
+		const std::vector<metapp::Variant> values = parser.extract(std::string(R"({"a":1,"b":tru})"), { "/a" });
+		if(skipWithoutValidating) {
+			REQUIRE(! parser.hasError());
+			REQUIRE(values[0].get<jsonpp::JsonInt>() == 1);
+		}
+		else {
+			REQUIRE(parser.hasError());
+			REQUIRE(values[0].isEmpty());
+		}
+	}
+	SECTION("malformed value in a skipped container") {
+		const std::vector<metapp::Variant> values = parser.extract(std::string(R"({"x":[1,nul],"a":1})"), { "/a" });
+		if(skipWithoutValidating) {
+			REQUIRE(! parser.hasError());
+			REQUIRE(values[0].get<jsonpp::JsonInt>() == 1);
+		}
+		else {
+			REQUIRE(parser.hasError());
+			REQUIRE(values[0].isEmpty());
+		}
+	}
+}
@@ -0,0 +1,189 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+
+#include "jsonpp/incrementalparser.h"
+#include "jsonpp/dumper.h"
+#include "metapp/allmetatypes.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <clocale>
+
+namespace {
+
+const std::string incrementalJsonText = R"({
+	"name" : "jsonpp\né😀",
+	"list" : [ 1, -2, 3.5, 1e3, true, false, null, [], {} ],
+	"nested" : { "a" : { "b" : [ "x", "y" ] } }
+})";
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("IncrementalParser, same as Parser", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	const metapp::Variant expected = jsonpp::Parser(jsonpp::ParserConfig().setBackendType<backendType>()).parse(incrementalJsonText);
+	const std::string expectedText = jsonpp::Dumper().dump(expected);
+
+	jsonpp::IncrementalParser parser;
+	// Split the document at every byte.
+	for(std::size_t split = 0; split <= incrementalJsonText.size(); ++split) {
+		REQUIRE(parser.feed(incrementalJsonText.data(), split));
+		REQUIRE(parser.feed(incrementalJsonText.data() + split, incrementalJsonText.size() - split));
+		REQUIRE(parser.isComplete());
+		const metapp::Variant result = parser.finish();
+		REQUIRE(! parser.hasError());
+		REQUIRE(jsonpp::Dumper().dump(result) == expectedText);
+	}
+}
+
+TEST_CASE("IncrementalParser, byte by byte")
+{
+	jsonpp::IncrementalParser parser;
+	for(const char c : incrementalJsonText) {
+		REQUIRE(parser.feed(&c, 1));
+	}
+	const metapp::Variant result = parser.finish();
+	const jsonpp::JsonObject & object = result.get<const jsonpp::JsonObject &>();
+	REQUIRE(object.at("name").get<const std::string &>() == "jsonpp\n\xc3\xa9\xf0\x9f\x98\x80");
+	const jsonpp::JsonArray & list = object.at("list").get<const jsonpp::JsonArray &>();
+	REQUIRE(list.size() == 9);
+	REQUIRE(list[1].get<jsonpp::JsonInt>() == -2);
+	REQUIRE(list[3].get<jsonpp::JsonReal>() == 1000.0);
+}
+
+TEST_CASE("IncrementalParser, large integers")
+{
+	jsonpp::IncrementalParser parser;
+	REQUIRE(parser.feed("[ -9223372036854775808, 9223372036854775807, 18446744073709551615 ]"));
+	const metapp::Variant result = parser.finish();
+	const jsonpp::JsonArray & list = result.get<const jsonpp::JsonArray &>();
+	REQUIRE(list[0].get<jsonpp::JsonInt>() == (std::numeric_limits<int64_t>::min)());
+	REQUIRE(list[1].get<jsonpp::JsonInt>() == (std::numeric_limits<int64_t>::max)());
+	REQUIRE(list[2].get<jsonpp::JsonUnsignedInt>() == (std::numeric_limits<uint64_t>::max)());
+}
+
+TEST_CASE("IncrementalParser, double doesn't depend on the locale")
+{
+	// Switch to a locale which uses ',' as the decimal separator, if any of them is installed.
+	const std::string oldLocale = std::setlocale(LC_NUMERIC, nullptr);
+	const char * localeNames[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR", "German" };
+	for(const char * localeName : localeNames) {
+		if(std::setlocale(LC_NUMERIC, localeName) != nullptr) {
+			break;
+		}
+	}
+
+	jsonpp::IncrementalParser parser;
+	REQUIRE(parser.feed("[ 1.5, -0.25e1, 3"));
+	REQUIRE(parser.feed(".75 ]"));
+	const std::vector<double> list = parser.finish<std::vector<double> >();
+	std::setlocale(LC_NUMERIC, oldLocale.c_str());
+
+	REQUIRE(! parser.hasError());
+	REQUIRE(list == std::vector<double> { 1.5, -2.5, 3.75 });
+}
+
+TEST_CASE("IncrementalParser, prototype")
+{
+	jsonpp::IncrementalParser parser;
+
+	REQUIRE(parser.feed("[ 1, 2"));
+	REQUIRE(parser.feed(", 3 ]"));
+	REQUIRE(parser.finish<std::vector<int> >() == std::vector<int> { 1, 2, 3 });
+
+	REQUIRE(parser.feed(R"({ "a" : 1, "b)"));
+	REQUIRE(parser.feed(R"(" : 2 })"));
+	const std::map<std::string, int> expected { { "a", 1 }, { "b", 2 } };
+	REQUIRE(parser.finish<std::map<std::string, int> >() == expected);
+}
+
+TEST_CASE("IncrementalParser, root scalar")
+{
+	jsonpp::IncrementalParser parser;
+
+	REQUIRE(parser.feed("12"));
+	REQUIRE(parser.feed("34"));
+	REQUIRE(! parser.isComplete());
+	REQUIRE(parser.finish<int>() == 1234);
+
+	REQUIRE(parser.feed("tr"));
+	REQUIRE(parser.feed("ue"));
+	REQUIRE(parser.finish<bool>());
+}
+
+TEST_CASE("IncrementalParser, comments")
+{
+	jsonpp::IncrementalParser parser(jsonpp::ParserConfig().enableComment(true));
+	REQUIRE(parser.feed("/* a */ [ 1, // b\n"));
+	REQUIRE(parser.feed(" 2 /"));
+	REQUIRE(parser.feed("* c */ ] // d"));
+	REQUIRE(parser.finish<std::vector<int> >() == std::vector<int> { 1, 2 });
+}
+
+TEST_CASE("IncrementalParser, errors")
+{
+	jsonpp::IncrementalParser parser;
+
+	SECTION("malformed") {
+		REQUIRE(parser.feed("[ 1, "));
+		REQUIRE(! parser.feed("] "));
+		REQUIRE(parser.hasError());
+		REQUIRE(! parser.feed("2 ]"));
+		REQUIRE(parser.finish().isEmpty());
+		REQUIRE(parser.hasError());
+	}
+	SECTION("incomplete") {
+		REQUIRE(parser.feed(R"({ "a" : [ 1 )"));
+		REQUIRE(parser.finish().isEmpty());
+		REQUIRE(parser.hasError());
+	}
+	SECTION("trailing content") {
+		REQUIRE(! parser.feed("[] []"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("empty") {
+		REQUIRE(parser.finish().isEmpty());
+		REQUIRE(parser.hasError());
+	}
+	SECTION("too deep") {
+		const std::string open(100000, '[');
+		REQUIRE(! parser.feed(open));
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.finish().isEmpty());
+	}
+	SECTION("max depth") {
+		const std::string jsonText = std::string(1024, '[') + std::string(1024, ']');
+		REQUIRE(parser.feed(jsonText));
+		REQUIRE(! parser.finish().isEmpty());
+		REQUIRE(! parser.hasError());
+	}
+	SECTION("number out of range") {
+		REQUIRE(! parser.feed("[ 1e400 ]"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("new document after error") {
+		REQUIRE(! parser.feed("[ 1 2 ]"));
+		parser.finish();
+		REQUIRE(parser.feed("[ 1, 2 ]"));
+		REQUIRE(! parser.hasError());
+		REQUIRE(parser.finish<std::vector<int> >() == std::vector<int> { 1, 2 });
+	}
+}
@@ -18,6 +18,9 @@
 #define private public
 #include "jsonpp/parser.h"
 
+#include <fstream>
+#include <cstdio>
+
 TEST_CASE("ParserSource, empty")
 {
 	SECTION("storage type") {
@@ -57,6 +60,42 @@ TEST_CASE("ParserSource, c string")
 	}
 }
 
+TEST_CASE("ParserSource, c string with capacity")
+{
+	std::string padded = "[ 1, 2 ]";
+	const std::size_t length = padded.size();
+	padded.resize(length + 64, '\0');
+	auto source = jsonpp::ParserSource(padded.data(), length, padded.size());
+	REQUIRE(source.storageType == jsonpp::ParserSource::StorageType::cstr);
+	REQUIRE(source.getTextLength() == length);
+	REQUIRE(source.getCapacity() == padded.size());
+	source.pad(64);
+	REQUIRE(source.storageType == jsonpp::ParserSource::StorageType::cstr);
+	REQUIRE(source.getText() == padded.data());
+
+	SECTION("capacity less than length") {
+		REQUIRE(jsonpp::ParserSource(padded.data(), length, 1).getCapacity() == length);
+	}
+}
+
+TEST_CASE("ParserSource, borrowed source is not changed by parsing")
+{
+	jsonpp::Parser parser;
+	const char * a = "[ 1 ]";
+	const char * b = "[ 2, 3 ]";
+	jsonpp::ParserSource sourceA(a, 5);
+	jsonpp::ParserSource sourceB(b, 8);
+	for(int i = 0; i < 2; ++i) {
+		const metapp::Variant resultA = parser.parse(sourceA);
+		REQUIRE(resultA.get<const jsonpp::JsonArray &>().size() == 1);
+		const metapp::Variant resultB = parser.parse(sourceB);
+		REQUIRE(resultB.get<const jsonpp::JsonArray &>().size() == 2);
+	}
+	REQUIRE(sourceA.storageType == jsonpp::ParserSource::StorageType::cstr);
+	REQUIRE(sourceA.getText() == a);
+	REQUIRE(sourceB.getText() == b);
+}
+
 TEST_CASE("ParserSource, ref")
 {
 	SECTION("storage type") {
@@ -112,3 +151,45 @@ TEST_CASE("ParserSource, std::string")
 	}
 }
 
+
+TEST_CASE("ParserSource, fromFile")
+{
+	const std::string fileName = "jsonpp_test_parsersource.json";
+
+	SECTION("file doesn't exist") {
+		auto source = jsonpp::ParserSource::fromFile("jsonpp_file_doesnt_exist.json");
+		REQUIRE(source.hasError());
+		jsonpp::Parser parser;
+		parser.parse(source);
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.getError() == source.getError());
+	}
+
+	// The sizes cover the slack in the last page both enough and not enough for the padding.
+	for(const std::size_t size : { std::size_t(0), std::size_t(3), std::size_t(4096 - 10), std::size_t(4096), std::size_t(8192 + 100) }) {
+		std::string content;
+		if(size > 0) {
+			content = "[" + std::string(size - 2, ' ') + "]";
+			content.resize(size, ' ');
+		}
+		{
+			std::ofstream file(fileName, std::ios::out | std::ios::binary);
+			file.write(content.data(), static_cast<std::streamsize>(content.size()));
+		}
+		auto source = jsonpp::ParserSource::fromFile(fileName);
+		REQUIRE(! source.hasError());
+		REQUIRE(source.storageType == jsonpp::ParserSource::StorageType::cstr);
+		REQUIRE(source.getTextLength() == size);
+		REQUIRE(std::string(source.getText(), source.getTextLength()) == content);
+		REQUIRE(source.getCapacity() >= size + jsonpp::ParserSource::filePadding);
+		const char * text = source.getText();
+		source.pad(jsonpp::ParserSource::filePadding);
+		// No copy
+		REQUIRE(source.storageType == jsonpp::ParserSource::StorageType::cstr);
+		REQUIRE(source.getText() == text);
+		if(size > 0) {
+			REQUIRE(jsonpp::Parser().parse(source).get<const jsonpp::JsonArray &>().empty());
+		}
+	}
+	std::remove(fileName.c_str());
+}
@@ -0,0 +1,265 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+
+#include "jsonpp/parallelparser.h"
+#include "metapp/allmetatypes.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+std::string makeJsonLines(const int count)
+{
+	std::string jsonText;
+	for(int i = 0; i < count; ++i) {
+		jsonText += "[ " + std::to_string(i) + ", " + std::to_string(i * 2) + " ]\n";
+	}
+	return jsonText;
+}
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, inputOrder", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+	parser.setChunkSize(64);
+	const std::string jsonText = makeJsonLines(1000);
+
+	std::vector<metapp::Variant> documentList;
+	REQUIRE(parser.parseMany(jsonText, [&documentList](const metapp::Variant & value) -> bool {
+		documentList.push_back(value);
+		return true;
+	}));
+	REQUIRE(documentList.size() == 1000);
+	for(int i = 0; i < 1000; ++i) {
+		REQUIRE(documentList[i].get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == i);
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, fastestFirst, prototype", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+	parser.setChunkSize(64).setOrder(jsonpp::ParallelOrder::fastestFirst);
+	const std::string jsonText = makeJsonLines(1000);
+
+	std::vector<std::vector<int> > documentList;
+	REQUIRE(parser.parseMany<std::vector<int> >(jsonText, [&documentList](const std::vector<int> & value) -> bool {
+		documentList.push_back(value);
+		return true;
+	}));
+	REQUIRE(documentList.size() == 1000);
+	std::sort(documentList.begin(), documentList.end());
+	for(int i = 0; i < 1000; ++i) {
+		REQUIRE(documentList[i] == std::vector<int> { i, i * 2 });
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, single chunk", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+	const std::string jsonText = makeJsonLines(10);
+
+	int count = 0;
+	REQUIRE(parser.parseMany(jsonText, [&count](const metapp::Variant &) -> bool {
+		++count;
+		return true;
+	}));
+	REQUIRE(count == 10);
+}
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, stop and errors", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+	parser.setChunkSize(64);
+	std::string jsonText = makeJsonLines(1000);
+	int count = 0;
+
+	SECTION("stop") {
+		REQUIRE(parser.parseMany(jsonText, [&count](const metapp::Variant &) -> bool {
+			++count;
+			return count < 3;
+		}));
+		REQUIRE(! parser.hasError());
+		REQUIRE(count == 3);
+	}
+	SECTION("malformed document") {
+		jsonText += "[ 1, ]\n";
+		jsonText += makeJsonLines(100);
+		REQUIRE(! parser.parseMany(jsonText, [&count](const metapp::Variant &) -> bool {
+			++count;
+			return true;
+		}));
+		REQUIRE(parser.hasError());
+		REQUIRE(count <= 1000);
+	}
+	SECTION("exception in callback") {
+		REQUIRE(! parser.parseMany(jsonText, [](const metapp::Variant &) -> bool {
+			throw std::runtime_error("callback error");
+		}));
+		REQUIRE(parser.getError() == "callback error");
+	}
+	SECTION("reuse after error") {
+		REQUIRE(! parser.parseMany(std::string("[ 1, ]\n") + jsonText, [](const metapp::Variant &) -> bool {
+			return true;
+		}));
+		REQUIRE(parser.parseMany(jsonText, [&count](const metapp::Variant &) -> bool {
+			++count;
+			return true;
+		}));
+		REQUIRE(count == 1000);
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, JsonStringView in prototype is rejected", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+	parser.setChunkSize(64);
+	std::string jsonText;
+	for(int i = 0; i < 200; ++i) {
+		jsonText += "[ \"a" + std::to_string(i) + "\", \"b" + std::to_string(i) + "\" ]\n";
+	}
+
+	std::size_t documentCount = 0;
+	const auto callback = [&documentCount](const metapp::Variant & /*value*/) -> bool {
+		++documentCount;
+		return true;
+	};
+	SECTION("inputOrder") {
+		REQUIRE(! parser.parseMany(jsonText, callback, metapp::getMetaType<std::vector<jsonpp::JsonStringView> >()));
+		REQUIRE(parser.hasError());
+		REQUIRE(documentCount == 0);
+	}
+	SECTION("fastestFirst") {
+		parser.setOrder(jsonpp::ParallelOrder::fastestFirst);
+		REQUIRE(! parser.parseMany(jsonText, callback, metapp::getMetaType<std::vector<jsonpp::JsonStringView> >()));
+		REQUIRE(parser.hasError());
+		REQUIRE(documentCount == 0);
+	}
+	SECTION("std::string is fine") {
+		std::vector<std::vector<std::string> > documentList;
+		REQUIRE(parser.parseMany<std::vector<std::string> >(jsonText, [&documentList](const std::vector<std::string> & value) -> bool {
+			documentList.push_back(value);
+			return true;
+		}));
+		REQUIRE(documentList.size() == 200);
+		REQUIRE(documentList[0] == std::vector<std::string> { "a0", "b0" });
+		REQUIRE(documentList[199] == std::vector<std::string> { "a199", "b199" });
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("ParallelParser, parseBatch", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParallelParser parser(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+
+	// Mix small and large documents, the first element of each document is its index.
+	std::vector<jsonpp::ParserSource> sourceList;
+	std::size_t byteCount = 0;
+	for(int i = 0; i < 200; ++i) {
+		std::string jsonText = "[ " + std::to_string(i);
+		for(int k = 0; k < (i % 50 == 0 ? 10000 : 2); ++k) {
+			jsonText += ", " + std::to_string(k);
+		}
+		jsonText += " ]";
+		byteCount += jsonText.size();
+		sourceList.emplace_back(std::move(jsonText));
+	}
+
+	SECTION("results in order") {
+		const std::vector<jsonpp::BatchParseResult> resultList = parser.parseBatch(sourceList);
+		REQUIRE(! parser.hasError());
+		REQUIRE(resultList.size() == 200);
+		for(int i = 0; i < 200; ++i) {
+			REQUIRE(resultList[i].errorMessage.empty());
+			REQUIRE(resultList[i].value.get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == i);
+		}
+
+		const jsonpp::BatchParseStats & stats = parser.getBatchStats();
+		REQUIRE(stats.documentCount == 200);
+		REQUIRE(stats.failedCount == 0);
+		REQUIRE(stats.byteCount == byteCount);
+		REQUIRE(stats.threadCount == 4);
+		REQUIRE(stats.maxDocumentTime <= stats.parseTime);
+	}
+	SECTION("prototype") {
+		const std::vector<jsonpp::BatchParseResult> resultList = parser.parseBatch<std::vector<int> >(sourceList);
+		REQUIRE(resultList[50].value.get<const std::vector<int> &>().size() == 10001);
+		REQUIRE(resultList[51].value.get<const std::vector<int> &>() == std::vector<int> { 51, 0, 1 });
+	}
+	SECTION("malformed documents don't stop the others") {
+		sourceList[3] = jsonpp::ParserSource(std::string("[ 3, "));
+		sourceList[7] = jsonpp::ParserSource(std::string("{ 7 }"));
+		const std::vector<jsonpp::BatchParseResult> resultList = parser.parseBatch(sourceList);
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.getError() == resultList[3].errorMessage);
+		REQUIRE(parser.getBatchStats().failedCount == 2);
+		for(int i = 0; i < 200; ++i) {
+			if(i == 3 || i == 7) {
+				REQUIRE(! resultList[i].errorMessage.empty());
+				REQUIRE(resultList[i].value.isEmpty());
+			}
+			else {
+				REQUIRE(resultList[i].value.get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == i);
+			}
+		}
+	}
+	SECTION("empty batch") {
+		REQUIRE(parser.parseBatch(std::vector<jsonpp::ParserSource>()).empty());
+		REQUIRE(! parser.hasError());
+		REQUIRE(parser.getBatchStats().documentCount == 0);
+	}
+	SECTION("worker threads are reused by the next calls") {
+		parser.setChunkSize(64);
+		const std::string jsonText = makeJsonLines(300);
+		for(int round = 0; round < 5; ++round) {
+			const std::vector<jsonpp::BatchParseResult> resultList = parser.parseBatch(sourceList);
+			REQUIRE(! parser.hasError());
+			REQUIRE(resultList[199].value.get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == 199);
+
+			std::size_t documentCount = 0;
+			REQUIRE(parser.parseMany(jsonText, [&documentCount](const metapp::Variant & /*value*/) -> bool {
+				++documentCount;
+				return true;
+			}));
+			REQUIRE(documentCount == 300);
+		}
+	}
+	SECTION("JsonStringView in prototype is rejected") {
+		std::vector<jsonpp::BatchParseResult> resultList = parser.parseBatch<std::vector<jsonpp::JsonStringView> >(sourceList);
+		REQUIRE(parser.hasError());
+		REQUIRE(resultList.size() == 200);
+		REQUIRE(resultList[0].value.isEmpty());
+		REQUIRE(! resultList[0].errorMessage.empty());
+		REQUIRE(parser.getBatchStats().failedCount == 200);
+
+		parser.parseBatch<std::map<std::string, std::vector<jsonpp::JsonStringView> > >(sourceList);
+		REQUIRE(parser.hasError());
+
+		resultList = parser.parseBatch<std::vector<int> >(sourceList);
+		REQUIRE(! parser.hasError());
+	}
+}
@@ -19,6 +19,10 @@
 #include "metapp/allmetatypes.h"
 
 #include <deque>
+#include <map>
+#include <vector>
+#include <string>
+#include <array>
 #include <unordered_map>
 #include <iostream>
 
@@ -67,6 +71,81 @@ TEMPLATE_LIST_TEST_CASE("Parse, array, proto", "", BackendTypes)
 	}
 }
 
+TEMPLATE_LIST_TEST_CASE("Parse, array, proto, numeric vector", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	SECTION("std::vector<double>") {
+		const auto array = parser.parse<std::vector<double> >(R"([ 1, -2, 3.5, true ])");
+		REQUIRE(! parser.hasError());
+		REQUIRE(array == std::vector<double> { 1, -2, 3.5, 1 });
+	}
+
+	SECTION("std::vector<float>") {
+		const auto array = parser.parse<std::vector<float> >(R"([ 1.5, 2 ])");
+		REQUIRE(array == std::vector<float> { 1.5f, 2.0f });
+	}
+
+	SECTION("std::vector<int>, out of range") {
+		parser.parse<std::vector<int> >(R"([ 1, 5000000000 ])");
+		REQUIRE(parser.hasError());
+	}
+
+	SECTION("std::vector<std::array<double, 2> >") {
+		const auto array = parser.parse<std::vector<std::array<double, 2> > >(R"([ [ 1, 2 ], [ 3.5, -4 ], [ 5 ], [ 6, 7, 8 ] ])");
+		REQUIRE(! parser.hasError());
+		REQUIRE(array.size() == 4);
+		REQUIRE(array[0] == std::array<double, 2> {{ 1, 2 }});
+		REQUIRE(array[1] == std::array<double, 2> {{ 3.5, -4 }});
+		REQUIRE(array[2] == std::array<double, 2> {{ 5, 0 }});
+		REQUIRE(array[3] == std::array<double, 2> {{ 6, 7 }});
+	}
+
+	SECTION("std::vector<std::vector<std::array<double, 2> > >") {
+		const auto array = parser.parse<std::vector<std::vector<std::array<double, 2> > > >(
+			R"([ [ [ -65.6, 43.5 ], [ -65.7, 43.4 ] ], [], [ [ 1, 2 ] ] ])"
+		);
+		REQUIRE(! parser.hasError());
+		REQUIRE(array.size() == 3);
+		REQUIRE(array[0].size() == 2);
+		REQUIRE(array[0][1] == std::array<double, 2> {{ -65.7, 43.4 }});
+		REQUIRE(array[1].empty());
+		REQUIRE(array[2][0] == std::array<double, 2> {{ 1, 2 }});
+	}
+
+	SECTION("parseInto std::vector<std::array<int, 3> >") {
+		std::vector<std::array<int, 3> > array(5);
+		REQUIRE(parser.parseInto(std::string(R"([ [ 1, 2, 3 ], [ 4, 5, 6 ] ])"), array));
+		REQUIRE(array.size() == 2);
+		REQUIRE(array[0] == std::array<int, 3> {{ 1, 2, 3 }});
+		REQUIRE(array[1] == std::array<int, 3> {{ 4, 5, 6 }});
+	}
+
+	// simdjsonOnDemand doesn't know the size before iterating, the vector grows while the numbers are appended.
+	SECTION("long std::vector<int>") {
+		std::string jsonText = "[";
+		std::vector<int> expected;
+		for(int i = 0; i < 1000; ++i) {
+			if(i > 0) {
+				jsonText += ",";
+			}
+			jsonText += std::to_string(i * 3);
+			expected.push_back(i * 3);
+		}
+		jsonText += "]";
+		REQUIRE(parser.parse<std::vector<int> >(jsonText) == expected);
+
+		std::vector<int> array(5, -1);
+		REQUIRE(parser.parseInto(jsonText, array));
+		REQUIRE(array == expected);
+		REQUIRE(parser.parseInto(std::string("[ 7, 8 ]"), array));
+		REQUIRE(array == std::vector<int> { 7, 8 });
+		REQUIRE(parser.parseInto(std::string("[]"), array));
+		REQUIRE(array.empty());
+	}
+}
+
 TEMPLATE_LIST_TEST_CASE("Parse, object", "", BackendTypes)
 {
 	constexpr auto backendType = TestType::backendType;
@@ -81,6 +160,36 @@ TEMPLATE_LIST_TEST_CASE("Parse, object", "", BackendTypes)
 	REQUIRE(object.at("b").get<jsonpp::JsonInt>() == 5);
 }
 
+TEMPLATE_LIST_TEST_CASE("Parse, object, escaped keys", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const std::string jsonText = R"(
+		{ "a\tb" : 5, "\u00e9" : "x\ny", "" : 6 }
+	)";
+
+	SECTION("default object") {
+		const auto object = parser.parse<jsonpp::JsonObject>(jsonText);
+		REQUIRE(object.size() == 3);
+		REQUIRE(object.at("a\tb").get<jsonpp::JsonInt>() == 5);
+		REQUIRE(object.at("\xc3\xa9").get<std::string &>() == "x\ny");
+		REQUIRE(object.at("").get<jsonpp::JsonInt>() == 6);
+	}
+
+	SECTION("map") {
+		const auto object = parser.parse<std::map<std::string, std::string> >(jsonText);
+		REQUIRE(object.at("\xc3\xa9") == "x\ny");
+	}
+
+	SECTION("key filter") {
+		jsonpp::Parser filterParser(jsonpp::ParserConfig().setBackendType<backendType>().excludeKeys({ "a\tb" }));
+		const metapp::Variant var = filterParser.parse(jsonText);
+		const jsonpp::JsonObject & object = var.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.size() == 2);
+		REQUIRE(object.find("a\tb") == object.end());
+	}
+}
+
 TEMPLATE_LIST_TEST_CASE("Parse, object, proto", "", BackendTypes)
 {
 	constexpr auto backendType = TestType::backendType;
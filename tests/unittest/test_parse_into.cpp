@@ -0,0 +1,157 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+#include "classes.h"
+
+#include "jsonpp/parser.h"
+#include "metapp/allmetatypes.h"
+
+#include <map>
+#include <vector>
+#include <array>
+#include <string>
+
+TEMPLATE_LIST_TEST_CASE("parseInto, scalar", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	int n = 5;
+	REQUIRE(parser.parseInto(std::string("38"), n));
+	REQUIRE(n == 38);
+
+	std::string s;
+	s.reserve(100);
+	const auto capacity = s.capacity();
+	REQUIRE(parser.parseInto(std::string(R"("abc")"), s));
+	REQUIRE(s == "abc");
+	REQUIRE(s.capacity() == capacity);
+}
+
+TEMPLATE_LIST_TEST_CASE("parseInto, std::vector reuses capacity", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	std::vector<int> array;
+	REQUIRE(parser.parseInto(std::string("[ 1, 2, 3, 4, 5, 6, 7, 8 ]"), array));
+	REQUIRE(array.size() == 8);
+	const auto data = array.data();
+
+	REQUIRE(parser.parseInto(std::string("[ 9, 10, 11 ]"), array));
+	REQUIRE(array == std::vector<int> { 9, 10, 11 });
+	REQUIRE(array.data() == data);
+
+	std::vector<std::vector<std::string> > nested;
+	REQUIRE(parser.parseInto(std::string(R"([ [ "a", "b" ], [ "c" ] ])"), nested));
+	REQUIRE(nested == std::vector<std::vector<std::string> > { { "a", "b" }, { "c" } });
+	const auto nestedData = nested[0].data();
+	REQUIRE(parser.parseInto(std::string(R"([ [ "d" ] ])"), nested));
+	REQUIRE(nested == std::vector<std::vector<std::string> > { { "d" } });
+	REQUIRE(nested[0].data() == nestedData);
+}
+
+TEMPLATE_LIST_TEST_CASE("parseInto, std::vector grows and shrinks", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	std::vector<std::vector<std::string> > nested { { "x" }, { "y" } };
+	REQUIRE(parser.parseInto(std::string(R"([ [ "a" ], [ "b", "c" ], [], [ "d" ] ])"), nested));
+	REQUIRE(nested == std::vector<std::vector<std::string> > { { "a" }, { "b", "c" }, {}, { "d" } });
+	REQUIRE(parser.parseInto(std::string(R"([ [ "e" ] ])"), nested));
+	REQUIRE(nested == std::vector<std::vector<std::string> > { { "e" } });
+	REQUIRE(parser.parseInto(std::string("[]"), nested));
+	REQUIRE(nested.empty());
+}
+
+TEMPLATE_LIST_TEST_CASE("parseInto, std::vector<std::array> with short inner array", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	std::vector<std::array<int, 3> > array;
+	REQUIRE(parser.parseInto(std::string("[ [ 1, 2, 3 ], [ 4, 5, 6 ] ]"), array));
+	REQUIRE(array == std::vector<std::array<int, 3> > { {{ 1, 2, 3 }}, {{ 4, 5, 6 }} });
+
+	// The missing numbers are zero, not the numbers of the previous parse.
+	REQUIRE(parser.parseInto(std::string("[ [ 7 ], [] ]"), array));
+	REQUIRE(array == std::vector<std::array<int, 3> > { {{ 7, 0, 0 }}, {{ 0, 0, 0 }} });
+}
+
+TEMPLATE_LIST_TEST_CASE("parseInto, class", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	TestClass2 obj = makeTestClass2(1);
+	const std::string jsonText = R"(
+		{
+			"i" : 5,
+			"vectorString" : [ "x", "y" ],
+			"obj1" : { "s" : "hello", "e" : "cat" },
+			"mapStringInt" : { "a" : 1 }
+		}
+	)";
+	const auto vectorStringData = obj.vectorString.data();
+	const auto listDequeLong = obj.obj1.listDequeLong;
+	REQUIRE(parser.parseInto(jsonText, obj));
+	REQUIRE(obj.i == 5);
+	REQUIRE(obj.vectorString == std::vector<std::string> { "x", "y" });
+	REQUIRE(obj.vectorString.data() == vectorStringData);
+	REQUIRE(obj.obj1.s == "hello");
+	REQUIRE(obj.obj1.e == TestEnum1::cat);
+	// fields not in the JSON keep their values
+	REQUIRE(obj.obj1.listDequeLong == listDequeLong);
+	REQUIRE(obj.getMapStringInt() == std::map<std::string, int> { { "a", 1 } });
+}
+
+TEMPLATE_LIST_TEST_CASE("parseInto, error", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	std::vector<int> array;
+	REQUIRE(! parser.parseInto(std::string("[ 1, 2"), array));
+	REQUIRE(parser.hasError());
+}
+
+// The target is unspecified after a failure, but it's still a valid object that can be parsed into again.
+TEMPLATE_LIST_TEST_CASE("parseInto, target after error", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	SECTION("std::vector<int>") {
+		std::vector<int> array { 5, 6, 7 };
+		REQUIRE(! parser.parseInto(std::string("[ 1, 2, tru ]"), array));
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.parseInto(std::string("[ 8, 9 ]"), array));
+		REQUIRE(array == std::vector<int> { 8, 9 });
+	}
+
+	SECTION("std::vector<std::string>") {
+		std::vector<std::string> array { "a", "b" };
+		REQUIRE(! parser.parseInto(std::string(R"([ "x", "y", )"), array));
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.parseInto(std::string(R"([ "c" ])"), array));
+		REQUIRE(array == std::vector<std::string> { "c" });
+	}
+
+	SECTION("class") {
+		TestClass2 obj = makeTestClass2(1);
+		REQUIRE(! parser.parseInto(std::string(R"({ "i" : 2, "vectorString" : [ "x", )"), obj));
+		REQUIRE(parser.hasError());
+		REQUIRE(parser.parseInto(std::string(R"({ "i" : 3, "vectorString" : [ "z" ] })"), obj));
+		REQUIRE(obj.i == 3);
+		REQUIRE(obj.vectorString == std::vector<std::string> { "z" });
+	}
+}
@@ -0,0 +1,128 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_parser.h"
+
+#include "jsonpp/parser.h"
+#include "metapp/allmetatypes.h"
+
+#include <vector>
+#include <string>
+
+TEMPLATE_LIST_TEST_CASE("parseMany, default types", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const std::string jsonText = R"({ "a" : 1, "b" : "x}" }
+[ 2, [ 3 ] ]
+5
+"s"
+null
+true
+
+{ "c" : {} }
+)";
+	std::vector<metapp::Variant> documentList;
+	REQUIRE(parser.parseMany(jsonText, [&documentList](const metapp::Variant & value) -> bool {
+		documentList.push_back(value);
+		return true;
+	}));
+	REQUIRE(documentList.size() == 7);
+	REQUIRE(documentList[0].get<const jsonpp::JsonObject &>().at("b").get<const std::string &>() == "x}");
+	REQUIRE(documentList[1].get<const jsonpp::JsonArray &>()[0].get<jsonpp::JsonInt>() == 2);
+	REQUIRE(documentList[2].get<jsonpp::JsonInt>() == 5);
+	REQUIRE(documentList[3].get<const std::string &>() == "s");
+	REQUIRE(jsonpp::getJsonType(documentList[4]) == jsonpp::JsonType::jtNull);
+	REQUIRE(documentList[5].get<jsonpp::JsonBool>());
+	REQUIRE(documentList[6].get<const jsonpp::JsonObject &>().at("c").get<const jsonpp::JsonObject &>().empty());
+}
+
+TEMPLATE_LIST_TEST_CASE("parseMany, prototype", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>().setBatchSize(64));
+	std::string jsonText;
+	for(int i = 0; i < 100; ++i) {
+		jsonText += "[ " + std::to_string(i) + ", " + std::to_string(i * 2) + " ]\n";
+	}
+
+	std::vector<std::vector<int> > documentList;
+	REQUIRE(parser.parseMany<std::vector<int> >(jsonText, [&documentList](const std::vector<int> & value) -> bool {
+		documentList.push_back(value);
+		return true;
+	}));
+	REQUIRE(documentList.size() == 100);
+	REQUIRE(documentList[99] == std::vector<int> { 99, 198 });
+
+	SECTION("stop") {
+		int count = 0;
+		REQUIRE(parser.parseMany<std::vector<int> >(jsonText, [&count](const std::vector<int> &) -> bool {
+			++count;
+			return count < 3;
+		}));
+		REQUIRE(count == 3);
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("parseMany, errors", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	int count = 0;
+	const auto callback = [&count](const metapp::Variant &) -> bool {
+		++count;
+		return true;
+	};
+
+	SECTION("empty") {
+		REQUIRE(parser.parseMany(std::string(" \n "), callback));
+		REQUIRE(count == 0);
+	}
+	SECTION("malformed document") {
+		REQUIRE(! parser.parseMany(std::string("[ 1 ]\n[ 2, ]\n[ 3 ]\n"), callback));
+		REQUIRE(parser.hasError());
+		REQUIRE(count <= 1);
+	}
+	SECTION("incomplete document at the end") {
+		REQUIRE(! parser.parseMany(std::string("[ 1 ]\n{ \"a\" : "), callback));
+		REQUIRE(parser.hasError());
+	}
+}
+
+TEST_CASE("parseMany, comment")
+{
+	// Only cparser supports comment.
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::cparser>().enableComment(true));
+	const std::string jsonText = R"(// leading comment
+[ 1 ] // note
+[ 1, /* ] */ 2 ]
+/* block
+comment */ 5// trailing
+"/* not a comment */"
+)";
+	std::vector<metapp::Variant> documentList;
+	REQUIRE(parser.parseMany(jsonText, [&documentList](const metapp::Variant & value) -> bool {
+		documentList.push_back(value);
+		return true;
+	}));
+	REQUIRE(! parser.hasError());
+	REQUIRE(documentList.size() == 4);
+	REQUIRE(documentList[0].get<const jsonpp::JsonArray &>().size() == 1);
+	REQUIRE(documentList[1].get<const jsonpp::JsonArray &>().size() == 2);
+	REQUIRE(documentList[1].get<const jsonpp::JsonArray &>()[1].get<jsonpp::JsonInt>() == 2);
+	REQUIRE(documentList[2].get<jsonpp::JsonInt>() == 5);
+	REQUIRE(documentList[3].get<const std::string &>() == "/* not a comment */");
+}
@@ -192,3 +192,64 @@ TEMPLATE_LIST_TEST_CASE("Parse, string", "", BackendTypes)
 	REQUIRE(var.get<std::string &>() == "abc");
 }
 
+
+TEMPLATE_LIST_TEST_CASE("Parse, scalar prototype, range check", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	SECTION("int8_t") {
+		REQUIRE(parser.parse<int8_t>(std::string("-128")) == -128);
+		REQUIRE(! parser.hasError());
+		parser.parse<int8_t>(std::string("128"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("uint16_t") {
+		REQUIRE(parser.parse<uint16_t>(std::string("65535")) == 65535);
+		REQUIRE(! parser.hasError());
+		parser.parse<uint16_t>(std::string("-1"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("int from double") {
+		REQUIRE(parser.parse<int>(std::string("3.5")) == 3);
+		REQUIRE(! parser.hasError());
+		parser.parse<int>(std::string("1e20"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("bool from number") {
+		REQUIRE(parser.parse<bool>(std::string("2")) == true);
+		REQUIRE(parser.parse<bool>(std::string("0")) == false);
+	}
+	SECTION("element out of range") {
+		parser.parse<std::vector<unsigned char> >(std::string("[ 1, 255, 256 ]"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("std::vector<float>") {
+		const auto array = parser.parse<std::vector<float> >(std::string("[ 1, -2, 3.5, true ]"));
+		REQUIRE(array == std::vector<float> { 1.0f, -2.0f, 3.5f, 1.0f });
+	}
+	SECTION("std::vector<std::string>") {
+		const auto array = parser.parse<std::vector<std::string> >(std::string(R"([ "a", "bc" ])"));
+		REQUIRE(array == std::vector<std::string> { "a", "bc" });
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("Parse, JsonStringView", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	SECTION("scalar") {
+		const jsonpp::JsonStringView view = parser.parse<jsonpp::JsonStringView>(std::string(R"("abc\ndef")"));
+		REQUIRE(! parser.hasError());
+		REQUIRE(view == jsonpp::JsonStringView("abc\ndef"));
+		REQUIRE(view.toString() == "abc\ndef");
+	}
+	SECTION("std::vector<JsonStringView>") {
+		// The views refer to the parser memory, they are valid until the next parse.
+		const auto array = parser.parse<std::vector<jsonpp::JsonStringView> >(std::string(R"([ "a", "", "xyz" ])"));
+		REQUIRE(array.size() == 3);
+		REQUIRE(array[0] == std::string("a"));
+		REQUIRE(array[1].empty());
+		REQUIRE(array[2] == std::string("xyz"));
+	}
+}
@@ -21,7 +21,7 @@
 
 #include "jsonpp/parser.h"
 
-#define PARSER_TYPES() GENERATE(jsonpp::ParserBackendType::cparser, jsonpp::ParserBackendType::simdjson)
+#define PARSER_TYPES() GENERATE(jsonpp::ParserBackendType::cparser, jsonpp::ParserBackendType::simdjson, jsonpp::ParserBackendType::simdjsonOnDemand, jsonpp::ParserBackendType::native)
 
 template <jsonpp::ParserBackendType type>
 struct TestBackendType
@@ -31,7 +31,9 @@ struct TestBackendType
 
 using BackendTypes = std::tuple<
 	TestBackendType<jsonpp::ParserBackendType::simdjson>,
-	TestBackendType<jsonpp::ParserBackendType::cparser>
+	TestBackendType<jsonpp::ParserBackendType::cparser>,
+	TestBackendType<jsonpp::ParserBackendType::simdjsonOnDemand>,
+	TestBackendType<jsonpp::ParserBackendType::native>
 >;
 
 #define DUMPER_CONFIGS() GENERATE( \
@@ -144,6 +144,44 @@ TEMPLATE_LIST_TEST_CASE("ParserConfig, setObjectType", "", BackendTypes)
 		REQUIRE(object[2][0] == "c");
 		REQUIRE(object[2][1] == "5");
 	}
+	SECTION("JsonHashObject") {
+		using T = jsonpp::JsonHashObject;
+		parserConfig.setObjectType<T>();
+		const std::string jsonText = R"({ "c" : 7, "a" : { "x" : "y" }, "b" : 5, "a" : 8 })";
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		REQUIRE(var.getMetaType()->equal(metapp::getMetaType<T>()));
+		const auto & object = var.get<const T &>();
+		REQUIRE(object.size() == 3);
+		// The members are in insertion order, duplicated key keeps the first value.
+		auto it = object.begin();
+		REQUIRE(it->first == "c");
+		REQUIRE((++it)->first == "a");
+		REQUIRE((++it)->first == "b");
+		REQUIRE(object.find("c")->second.get<jsonpp::JsonInt>() == 7);
+		REQUIRE(object.find("b")->second.get<jsonpp::JsonInt>() == 5);
+		REQUIRE(object.find("notExist") == object.end());
+		const auto & nested = object.find("a")->second.get<const T &>();
+		REQUIRE(nested.find("x")->second.get<const std::string &>() == "y");
+	}
+	SECTION("JsonFlatObject") {
+		using T = jsonpp::JsonFlatObject;
+		parserConfig.setObjectType<T>();
+		const std::string jsonText = R"({ "c" : 7, "a" : { "y" : 1, "x" : 2 }, "b" : 5, "a" : 8 })";
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		REQUIRE(var.getMetaType()->equal(metapp::getMetaType<T>()));
+		const auto & object = var.get<const T &>();
+		// The members are sorted by key, duplicated key keeps the first value.
+		REQUIRE(object.size() == 3);
+		REQUIRE(object[0].first == "a");
+		REQUIRE(object[1].first == "b");
+		REQUIRE(object[1].second.get<jsonpp::JsonInt>() == 5);
+		REQUIRE(object[2].first == "c");
+		REQUIRE(object[2].second.get<jsonpp::JsonInt>() == 7);
+		const auto & nested = object[0].second.get<const T &>();
+		REQUIRE(nested[0].first == "x");
+		REQUIRE(nested[0].second.get<jsonpp::JsonInt>() == 2);
+		REQUIRE(nested[1].first == "y");
+	}
 	SECTION("prototype suppresses object type") {
 		parserConfig.setObjectType<std::map<std::string, long> >();
 		const std::string jsonText = R"({ "a" : 7, "b" : -6, "c" : 5 })";
@@ -154,3 +192,241 @@ TEMPLATE_LIST_TEST_CASE("ParserConfig, setObjectType", "", BackendTypes)
 	}
 }
 
+
+TEMPLATE_LIST_TEST_CASE("ParserConfig, includeKeys and excludeKeys", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	const std::string jsonText = R"({
+		"id" : 1,
+		"text" : "abc",
+		"entities" : [ { "id" : 2, "entities" : [] } ],
+		"user" : { "id" : 3, "name" : "def", "entities" : {} }
+	})";
+
+	SECTION("exclude at any depth") {
+		parserConfig.excludeKeys({ "entities" });
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = var.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.size() == 3);
+		REQUIRE(object.count("entities") == 0);
+		REQUIRE(object.at("user").get<const jsonpp::JsonObject &>().size() == 2);
+	}
+	SECTION("exclude at depth") {
+		parserConfig.excludeKeys({ "id" }, 1);
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = var.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.count("id") == 1);
+		REQUIRE(object.at("user").get<const jsonpp::JsonObject &>().count("id") == 0);
+		// The object in the array has depth 2.
+		const auto & entity = object.at("entities").get<const jsonpp::JsonArray &>()[0].get<const jsonpp::JsonObject &>();
+		REQUIRE(entity.count("id") == 1);
+	}
+	SECTION("include at depth") {
+		parserConfig.includeKeys({ "id", "user" }, 0).includeKeys({ "name" }, 1);
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = var.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.size() == 2);
+		REQUIRE(object.at("id").get<jsonpp::JsonInt>() == 1);
+		const auto & user = object.at("user").get<const jsonpp::JsonObject &>();
+		REQUIRE(user.size() == 1);
+		REQUIRE(user.at("name").get<const std::string &>() == "def");
+	}
+	SECTION("exclude takes precedence") {
+		parserConfig.includeKeys({ "id", "text" }, 0).excludeKeys({ "text" });
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = var.get<const jsonpp::JsonObject &>();
+		REQUIRE(object.size() == 1);
+		REQUIRE(object.count("id") == 1);
+	}
+	SECTION("other object types") {
+		parserConfig.excludeKeys({ "entities", "text" });
+		parserConfig.setObjectType<jsonpp::JsonFlatObject>();
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		const auto & object = var.get<const jsonpp::JsonFlatObject &>();
+		REQUIRE(object.size() == 2);
+		REQUIRE(object[0].first == "id");
+		REQUIRE(object[1].first == "user");
+	}
+	SECTION("not applied to prototype") {
+		parserConfig.excludeKeys({ "a" });
+		const auto result = jsonpp::Parser(parserConfig).parse<std::map<std::string, int> >(std::string(R"({ "a" : 1, "b" : 2 })"));
+		REQUIRE(result.size() == 2);
+	}
+	SECTION("copies of the config are independent") {
+		parserConfig.excludeKeys({ "id" });
+		jsonpp::ParserConfig copy = parserConfig;
+		copy.excludeKeys({ "text" });
+		const metapp::Variant var = jsonpp::Parser(parserConfig).parse(jsonText);
+		REQUIRE(var.get<const jsonpp::JsonObject &>().count("text") == 1);
+	}
+}
+
+namespace {
+
+std::string makeLargeJsonArray(const int count)
+{
+	std::string text = "[";
+	for(int i = 0; i < count; ++i) {
+		if(i > 0) {
+			text += ",";
+		}
+		text += std::to_string(i);
+	}
+	text += "]";
+	return text;
+}
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("ParserConfig, initial capacity and huge pages", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	parserConfig.setInitialCapacity(64 * 1024);
+	parserConfig.enableHugePages(true);
+	jsonpp::Parser parser(parserConfig);
+
+	const auto small = parser.parse<std::vector<int> >("[5, 6]");
+	REQUIRE(small == std::vector<int> { 5, 6 });
+
+	// Larger than the initial capacity, the buffers grow.
+	const auto large = parser.parse<std::vector<int> >(makeLargeJsonArray(100000));
+	REQUIRE(large.size() == 100000);
+	REQUIRE(large[99999] == 99999);
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserConfig, max capacity", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	parserConfig.setMaxCapacity(1024);
+	jsonpp::Parser parser(parserConfig);
+
+	REQUIRE(parser.parse<std::vector<int> >("[5, 6]") == std::vector<int> { 5, 6 });
+	REQUIRE(! parser.hasError());
+
+	parser.parse(makeLargeJsonArray(10000));
+	if(backendType != jsonpp::ParserBackendType::cparser) {
+		REQUIRE(parser.hasError());
+	}
+
+	// The parser still works after the failure.
+	REQUIRE(parser.parse<std::vector<int> >("[7]") == std::vector<int> { 7 });
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserConfig, release memory size", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	parserConfig.setReleaseMemorySize(64 * 1024);
+	jsonpp::Parser parser(parserConfig);
+
+	const auto large = parser.parse<std::vector<int> >(makeLargeJsonArray(100000));
+	REQUIRE(large.size() == 100000);
+
+	// The memory is released by the next parse.
+	REQUIRE(parser.parse<std::vector<int> >("[5, 6]") == std::vector<int> { 5, 6 });
+	REQUIRE(parser.getMemorySize() <= 64 * 1024);
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserConfig, release memory size keeps the views of the last parse", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<backendType>();
+	parserConfig.setReleaseMemorySize(1);
+	jsonpp::Parser parser(parserConfig);
+
+	const std::string longText(1000, 'a');
+	for(int i = 0; i < 3; ++i) {
+		const jsonpp::JsonStringView view = parser.parse<jsonpp::JsonStringView>(std::string("\"" + longText + "\\n\""));
+		REQUIRE(! parser.hasError());
+		REQUIRE(view.toString() == longText + "\n");
+
+		const auto viewList = parser.parse<std::vector<jsonpp::JsonStringView> >(std::string(R"([ "abc\tdef", "xyz" ])"));
+		REQUIRE(! parser.hasError());
+		REQUIRE(viewList.size() == 2);
+		REQUIRE(viewList[0] == std::string("abc\tdef"));
+		REQUIRE(viewList[1] == std::string("xyz"));
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, memory is reused across parses", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+	const std::string jsonText = makeLargeJsonArray(10000);
+
+	std::size_t memorySize = 0;
+	for(int i = 0; i < 4; ++i) {
+		REQUIRE(parser.parse<std::vector<int> >(jsonText).size() == 10000);
+		// The memory settles after a few parses, it doesn't grow with the parse count.
+		if(i == 3) {
+			REQUIRE(parser.getMemorySize() == memorySize);
+		}
+		memorySize = parser.getMemorySize();
+	}
+	REQUIRE(memorySize > 0);
+}
+
+TEST_CASE("ParserConfig, automatic backend")
+{
+	jsonpp::ParserConfig parserConfig;
+	parserConfig.setBackendType<jsonpp::ParserBackendType::automatic>();
+	jsonpp::AutoBackendThresholds thresholds;
+	const std::string jsonText = makeLargeJsonArray(1000);
+
+	SECTION("small documents use cparser") {
+		thresholds.smallSize = jsonText.size() + 1;
+		jsonpp::Parser parser(parserConfig.setAutoThresholds(thresholds));
+		REQUIRE(parser.parse<std::vector<int> >(jsonText).size() == 1000);
+		// cparser accepts the trailing comma.
+		REQUIRE(parser.parse<std::vector<int> >("[5, 6, ]") == std::vector<int> { 5, 6 });
+		REQUIRE(! parser.hasError());
+	}
+
+	SECTION("medium documents use native") {
+		thresholds.smallSize = 0;
+		thresholds.largeSize = jsonText.size() + 1;
+		thresholds.largeSparseSize = jsonText.size() + 1;
+		jsonpp::Parser parser(parserConfig.setAutoThresholds(thresholds));
+		REQUIRE(parser.parse<std::vector<int> >(jsonText).size() == 1000);
+		parser.parse<std::vector<int> >("[5, 6, ]");
+		REQUIRE(parser.hasError());
+	}
+
+	SECTION("large documents use simdjson") {
+		thresholds.smallSize = 0;
+		thresholds.largeSize = 0;
+		thresholds.largeSparseSize = 0;
+		jsonpp::Parser parser(parserConfig.setAutoThresholds(thresholds));
+		REQUIRE(parser.parse<std::vector<int> >(jsonText).size() == 1000);
+		parser.parse<std::vector<int> >("[5, 6, ]");
+		REQUIRE(parser.hasError());
+	}
+
+	SECTION("comment always uses cparser") {
+		thresholds.smallSize = 0;
+		thresholds.largeSize = 0;
+		thresholds.largeSparseSize = 0;
+		jsonpp::Parser parser(parserConfig.setAutoThresholds(thresholds).enableComment(true));
+		REQUIRE(parser.parse<std::vector<int> >("[5 /* comment */, 6]") == std::vector<int> { 5, 6 });
+		REQUIRE(! parser.hasError());
+	}
+
+	SECTION("calibrated thresholds") {
+		thresholds = jsonpp::calibrateAutoBackend();
+		REQUIRE(thresholds.smallSize <= thresholds.largeSparseSize);
+		REQUIRE(thresholds.largeSparseSize <= thresholds.largeSize);
+		REQUIRE(thresholds.largeSize <= 2 * 1024 * 1024);
+		jsonpp::Parser parser(parserConfig.setAutoThresholds(thresholds));
+		REQUIRE(parser.parse<std::vector<int> >(jsonText).size() == 1000);
+		REQUIRE(parser.parse<std::vector<int> >("[5, 6]") == std::vector<int> { 5, 6 });
+		REQUIRE(! parser.hasError());
+	}
+}
@@ -0,0 +1,156 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// The tests specific to the native backend, such as the SIMD block boundaries and its own number and string conversion.
+// The behaviors shared by all backends are tested with BackendTypes in the other files.
+
+#include "test_parser.h"
+#include "classes.h"
+
+#include "metapp/allmetatypes.h"
+
+#include <limits>
+
+TEST_CASE("Native, string length around the block size")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	// The block is 16 bytes, the strings end before, at and after the block boundary.
+	for(std::size_t length = 14; length <= 18; ++length) {
+		const std::string plain(length, 'a');
+		// The escape is the last character, so it straddles the boundary for some lengths.
+		const std::string escaped = std::string(length - 1, 'b') + "\\n";
+		const std::string jsonText = "[\"" + plain + "\",\"" + escaped + "\",\"" + plain + "\"]";
+		const auto array = parser.parse<std::vector<std::string> >(jsonText);
+		REQUIRE(! parser.hasError());
+		REQUIRE(array.size() == 3);
+		REQUIRE(array[0] == plain);
+		REQUIRE(array[1] == std::string(length - 1, 'b') + "\n");
+		REQUIRE(array[2] == plain);
+
+		REQUIRE(parser.parse<std::string>("\"" + plain + "\"") == plain);
+		REQUIRE(! parser.hasError());
+	}
+}
+
+TEST_CASE("Native, unicode escape")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	SECTION("basic multilingual plane") {
+		REQUIRE(parser.parse<std::string>(std::string(R"("\u0041\u00e9\u4e2d")")) == "A\xc3\xa9\xe4\xb8\xad");
+		REQUIRE(! parser.hasError());
+	}
+	SECTION("surrogate pair") {
+		REQUIRE(parser.parse<std::string>(std::string(R"("\ud83d\ude00")")) == "\xf0\x9f\x98\x80");
+		REQUIRE(! parser.hasError());
+	}
+	SECTION("lone high surrogate") {
+		parser.parse(std::string(R"("\ud83d")"));
+		REQUIRE(parser.hasError());
+		parser.parse(std::string(R"("\ud83dabc")"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("lone low surrogate") {
+		parser.parse(std::string(R"("\ude00")"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("high surrogate followed by a non low surrogate") {
+		parser.parse(std::string(R"("\ud83dA")"));
+		REQUIRE(parser.hasError());
+	}
+	SECTION("invalid hex digits") {
+		parser.parse(std::string(R"("\u12g4")"));
+		REQUIRE(parser.hasError());
+		parser.parse(std::string(R"("\u12")"));
+		REQUIRE(parser.hasError());
+	}
+}
+
+TEST_CASE("Native, integer limits")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	SECTION("int64 min") {
+		metapp::Variant var = parser.parse(std::string("-9223372036854775808"));
+		REQUIRE(jsonpp::getJsonType(var) == jsonpp::JsonType::jtInt);
+		REQUIRE(var.get<jsonpp::JsonInt>() == (std::numeric_limits<int64_t>::min)());
+	}
+	SECTION("uint64 max") {
+		metapp::Variant var = parser.parse(std::string("18446744073709551615"));
+		REQUIRE(jsonpp::getJsonType(var) == jsonpp::JsonType::jtUnsignedInt);
+		REQUIRE(var.get<jsonpp::JsonUnsignedInt>() == (std::numeric_limits<uint64_t>::max)());
+	}
+	SECTION("overflow to double") {
+		metapp::Variant var = parser.parse(std::string("18446744073709551616"));
+		REQUIRE(jsonpp::getJsonType(var) == jsonpp::JsonType::jtDouble);
+		REQUIRE(var.get<jsonpp::JsonReal>() == 18446744073709551616.0);
+
+		var = parser.parse(std::string("-9223372036854775809"));
+		REQUIRE(jsonpp::getJsonType(var) == jsonpp::JsonType::jtDouble);
+		REQUIRE(var.get<jsonpp::JsonReal>() == -9223372036854775809.0);
+	}
+}
+
+TEST_CASE("Native, double")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	REQUIRE(parser.parse<double>(std::string("0.1")) == 0.1);
+	REQUIRE(parser.parse<double>(std::string("-1.5e-3")) == -1.5e-3);
+	REQUIRE(parser.parse<double>(std::string("1e23")) == 1e23);
+	REQUIRE(parser.parse<double>(std::string("0.30000000000000004")) == 0.30000000000000004);
+	REQUIRE(parser.parse<double>(std::string("3.141592653589793238462643383279")) == 3.141592653589793);
+	REQUIRE(parser.parse<double>(std::string("2.2250738585072014e-308")) == 2.2250738585072014e-308);
+	REQUIRE(! parser.hasError());
+
+	parser.parse(std::string("1e400"));
+	REQUIRE(parser.hasError());
+}
+
+TEST_CASE("Native, malformed")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	const char * jsonTextList[] = {
+		"[1 2]",
+		R"({"a" 1})",
+		"[1,]",
+		R"({"a":1,})",
+		"[1}",
+		R"({"a":[1}])",
+		"[[1]",
+		"[1]]",
+		"[01]",
+		"[1.]",
+		"[tru]",
+	};
+	for(const char * jsonText : jsonTextList) {
+		parser.parse(std::string(jsonText));
+		INFO(jsonText);
+		REQUIRE(parser.hasError());
+	}
+}
+
+TEST_CASE("Native, skipped class member with invalid literal")
+{
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<jsonpp::ParserBackendType::native>());
+	// The skipped scalar is validated, even though its value is not read.
+	parser.parse<TestClass1>(std::string(R"({ "s" : "Hello", "unknown" : tru })"));
+	REQUIRE(parser.hasError());
+	parser.parse<TestClass1>(std::string(R"({ "unknown" : nul, "s" : "Hello" })"));
+	REQUIRE(parser.hasError());
+
+	const TestClass1 obj = parser.parse<TestClass1>(std::string(R"({ "unknown" : true, "s" : "Hello" })"));
+	REQUIRE(! parser.hasError());
+	REQUIRE(obj.s == "Hello");
+}
@@ -0,0 +1,115 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "test_parser.h"
+
+#include "jsonpp/parserpool.h"
+#include "metapp/allmetatypes.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+TEMPLATE_LIST_TEST_CASE("ParserPool, reuse", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserPool pool(jsonpp::ParserConfig().setBackendType<backendType>(), 2);
+	REQUIRE(pool.getMaxIdleCount() == 2);
+
+	jsonpp::Parser * first = nullptr;
+	{
+		jsonpp::ParserPool::Lease lease = pool.acquire();
+		first = &*lease;
+		REQUIRE(lease->parse<std::vector<int> >(std::string("[ 1, 2 ]")) == std::vector<int> { 1, 2 });
+		REQUIRE(pool.getStats().inUseCount == 1);
+		REQUIRE(pool.getStats().idleCount == 0);
+	}
+	REQUIRE(pool.getStats().inUseCount == 0);
+	REQUIRE(pool.getStats().idleCount == 1);
+	{
+		jsonpp::ParserPool::Lease lease = pool.acquire();
+		REQUIRE(&lease.get() == first);
+	}
+	REQUIRE(pool.getStats().createdCount == 1);
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserPool, max idle count", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserPool pool(jsonpp::ParserConfig().setBackendType<backendType>(), 2);
+	{
+		std::vector<jsonpp::ParserPool::Lease> leaseList;
+		for(int i = 0; i < 5; ++i) {
+			leaseList.push_back(pool.acquire());
+		}
+		REQUIRE(pool.getStats().inUseCount == 5);
+		REQUIRE(pool.getStats().createdCount == 5);
+	}
+	REQUIRE(pool.getStats().inUseCount == 0);
+	REQUIRE(pool.getStats().idleCount == 2);
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserPool, memory ceiling", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserPool pool(jsonpp::ParserConfig().setBackendType<backendType>(), 2);
+	pool.setMemoryCeiling(64 * 1024);
+	REQUIRE(pool.getMemoryCeiling() == 64 * 1024);
+
+	std::string jsonText = "[ 0";
+	for(int i = 1; i < 100000; ++i) {
+		jsonText += ", " + std::to_string(i);
+	}
+	jsonText += " ]";
+	{
+		jsonpp::ParserPool::Lease lease = pool.acquire();
+		REQUIRE(lease->parse<std::vector<int> >(jsonText.c_str(), jsonText.size()).size() == 100000);
+	}
+	REQUIRE(pool.getStats().idleMemorySize <= 64 * 1024);
+	{
+		jsonpp::ParserPool::Lease lease = pool.acquire();
+		REQUIRE(lease->getMemorySize() <= 64 * 1024);
+		REQUIRE(lease->parse<std::vector<int> >(std::string("[ 3 ]")) == std::vector<int> { 3 });
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("ParserPool, multiple threads", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::ParserPool pool(jsonpp::ParserConfig().setBackendType<backendType>(), 4);
+
+	std::atomic<int> failedCount(0);
+	std::vector<std::thread> threadList;
+	for(int t = 0; t < 4; ++t) {
+		threadList.emplace_back([&pool, &failedCount, t]() {
+			for(int i = 0; i < 200; ++i) {
+				jsonpp::ParserPool::Lease lease = pool.acquire();
+				const std::vector<int> result = lease->parse<std::vector<int> >("[ " + std::to_string(t) + ", " + std::to_string(i) + " ]");
+				if(result != std::vector<int> { t, i }) {
+					++failedCount;
+				}
+			}
+		});
+	}
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+	REQUIRE(failedCount == 0);
+	REQUIRE(pool.getStats().inUseCount == 0);
+	REQUIRE(pool.getStats().idleCount <= 4);
+}
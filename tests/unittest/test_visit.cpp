@@ -0,0 +1,135 @@
+// jsonpp library
+// 
+// Copyright (C) 2022 Wang Qi (wqking)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//   http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "test_parser.h"
+
+#include "jsonpp/parser.h"
+
+#include <string>
+
+namespace {
+
+// Records the events as text, such as "{2 k:a i:1 ...}".
+class RecordingHandler : public jsonpp::ParserHandler
+{
+public:
+	void onNull() override {
+		text += "n ";
+	}
+
+	void onBool(const bool value) override {
+		text += (value ? "true " : "false ");
+	}
+
+	void onInt(const int64_t value) override {
+		text += "i:" + std::to_string(value) + " ";
+	}
+
+	void onUint(const uint64_t value) override {
+		text += "u:" + std::to_string(value) + " ";
+	}
+
+	void onDouble(const double value) override {
+		text += "d:" + std::to_string(value) + " ";
+	}
+
+	void onString(const jsonpp::JsonStringView & value) override {
+		text += "s:" + value.toString() + " ";
+	}
+
+	void onStartObject(const std::size_t size) override {
+		text += "{" + std::to_string(size) + " ";
+	}
+
+	void onKey(const jsonpp::JsonStringView & key) override {
+		text += "k:" + key.toString() + " ";
+	}
+
+	void onEndObject() override {
+		text += "} ";
+	}
+
+	void onStartArray(const std::size_t size) override {
+		text += "[" + std::to_string(size) + " ";
+	}
+
+	void onEndArray() override {
+		text += "] ";
+	}
+
+	std::string text;
+};
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("Parser, visit", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	RecordingHandler handler;
+	REQUIRE(parser.visit(R"({ "a" : 1, "b" : [ true, false, null, "x\ny" ], "c" : { "d" : -5, "e" : 1.5 }, "f" : {}, "g" : [] })", handler));
+	REQUIRE(! parser.hasError());
+	REQUIRE(handler.text ==
+		"{5 k:a i:1 k:b [4 true false n s:x\ny ] k:c {2 k:d i:-5 k:e d:1.500000 } k:f {0 } k:g [0 ] } "
+	);
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, visit, scalar root", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	{
+		RecordingHandler handler;
+		REQUIRE(parser.visit(std::string("\"abc\""), handler));
+		REQUIRE(handler.text == "s:abc ");
+	}
+	{
+		RecordingHandler handler;
+		REQUIRE(parser.visit(std::string("null"), handler));
+		REQUIRE(handler.text == "n ");
+	}
+	{
+		RecordingHandler handler;
+		const std::string jsonText = "123";
+		REQUIRE(parser.visit(jsonText.c_str(), jsonText.size(), handler));
+		REQUIRE(handler.text == "i:123 ");
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, visit, default handler", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	jsonpp::ParserHandler handler;
+	REQUIRE(parser.visit(std::string(R"([ 1, { "a" : "b" } ])"), handler));
+}
+
+TEMPLATE_LIST_TEST_CASE("Parser, visit, error", "", BackendTypes)
+{
+	constexpr auto backendType = TestType::backendType;
+	jsonpp::Parser parser(jsonpp::ParserConfig().setBackendType<backendType>());
+
+	RecordingHandler handler;
+	REQUIRE(! parser.visit(std::string(R"({ "a" : [ 1, 2 )"), handler));
+	REQUIRE(parser.hasError());
+
+	REQUIRE(parser.visit(std::string("[ 1 ]"), handler));
+	REQUIRE(! parser.hasError());
+}